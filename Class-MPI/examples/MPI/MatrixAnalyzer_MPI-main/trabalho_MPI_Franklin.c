@@ -1,29 +1,124 @@
 // Comando para gerar o executável:
-// mpicc -o trabalho_MPI_Franklin trabalho_MPI_Franklin.c -lm
+// g++ -O3 -march=native -fopenmp-simd -c ../../../../common/stats_kernels.cpp
+// mpicc -O3 -march=native -I../../../../common -o trabalho_MPI_Franklin trabalho_MPI_Franklin.c stats_kernels.o -lm
 
 // explicação sobre a flag -lm:
-// math.h is not a part of the standard C library, so you have to link to it! 
+// math.h is not a part of the standard C library, so you have to link to it!
 // link da explicação: https://stackoverflow.com/questions/44175151/what-is-the-meaning-of-lm-in-gcc
 
 // Comando para executar
-// mpirun -np 4 ./trabalho_MPI_Franklin
+// mpirun -np 4 ./trabalho_MPI_Franklin                  (matriz 1000x1000 gerada)
+// mpirun -np 4 ./trabalho_MPI_Franklin -n 50000         (matriz 50000x50000 gerada em blocos)
+// mpirun -np 4 ./trabalho_MPI_Franklin -s 42            (semente fixa: mesma matriz com qualquer -np)
+// mpirun -np 4 ./trabalho_MPI_Franklin -n 20000 -s 7 -o matriz.mat  (gera e grava no formato de matriz)
+// mpirun -np 4 ./trabalho_MPI_Franklin -f matriz.mat    (formato de matriz: cada rank lê as suas linhas)
+// mpirun -np 4 ./trabalho_MPI_Franklin -f matriz.bin -n 20000   (int32 cru row-major, via rank 0)
+// mpirun -np 4 ./trabalho_MPI_Franklin -f matriz.bin -n 20000 -t 0.9   (esparso na rede só acima de 90% de zeros)
 
 #include <mpi.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <limits.h>
 #include <time.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "running_stats.h" // Welford/Chan + operação MPI (pasta common/ na raiz)
+#include "node_reduce.h"   // redução hierárquica por nó (pasta common/)
+#include "philox.h"        // gerador baseado em contador (pasta common/)
+#include "sparse_matrix.h" // blocos densos, bitmap ou CSR (pasta common/)
+#include "matrix_file.h"   // formato binário de matriz com cabeçalho (pasta common/)
+#include "stats_kernels.h" // kernels SIMD (AVX2/AVX-512) da pasta common/
 
-#define N 1000 // Define o tamanho da matriz
+#define DEFAULT_N 1000           // Tamanho padrão da matriz
+#define DEFAULT_CHUNK_ROWS 256   // Linhas por bloco enviado a cada rodada
+#define DEFAULT_ZERO_THRESHOLD 0.5 // Fração de zeros acima da qual o bloco vai esparso
+#define PROGRESS_ELEMENTS (64 * 2048) // Elementos analisados entre chamadas de MPI_Test
 
-// Função para gerar uma matriz com valores aleatórios entre -1000 e 1000
-void generate_matrix(int matrix[N][N]) {
-    srand(time(NULL)); // Semente para gerar números aleatórios
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            matrix[i][j] = (rand() % 2001) - 1000; // Valores entre -1000 e 1000
-        }
+// Gera as linhas [first_row, first_row + rows) de uma matriz n x n com
+// valores aleatórios entre -1000 e 1000. Cada elemento depende só do seu
+// índice global e da semente (Philox), então cada rank gera a sua parte de
+// cada bloco sem nada passar pela rede e a matriz é a mesma para qualquer
+// número de processos.
+void generate_rows(int *rows_data, long long n, long long first_row, int rows, uint64_t seed) {
+    philox_fill_ints(rows_data, (uint64_t)first_row * n, (long long)rows * n, seed, -1000, 1000);
+}
+
+// Origem dos dados: gerados (Philox), arquivo no formato de matriz
+// (matrix_file.h, lido em paralelo por todos os ranks) ou arquivo cru só com
+// os inteiros (lido pelo rank 0 e distribuído)
+enum { SOURCE_GENERATED, SOURCE_MATRIX_FILE, SOURCE_RAW_FILE };
+
+// Arquivo cru lido no rank 0. A matriz nunca é carregada inteira: o
+// mapeamento é paginado sob demanda pelo sistema operacional, então o arquivo
+// pode ser maior que a RAM.
+typedef struct {
+    long long n;        // dimensão (n x n)
+    int *mapped;        // matriz inteira mapeada
+    size_t mapped_size;
+} MatrixSource;
+
+int open_source(MatrixSource *src, const char *filename, long long n) {
+    src->n = n;
+    src->mapped = NULL;
+    src->mapped_size = (size_t)n * n * sizeof(int);
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < src->mapped_size) {
+        fprintf(stderr, "%s: expected at least %zu bytes (%lldx%lld int32)\n", filename, src->mapped_size, n, n);
+        close(fd);
+        return -1;
+    }
+    src->mapped = (int *)mmap(NULL, src->mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (src->mapped == MAP_FAILED) {
+        src->mapped = NULL;
+        return -1;
+    }
+    // Leitura sequencial: o kernel pode fazer read-ahead agressivo
+    madvise(src->mapped, src->mapped_size, MADV_SEQUENTIAL);
+    return 0;
+}
+
+// Devolve um ponteiro para as linhas a partir de first_row
+const int *source_rows(MatrixSource *src, long long first_row) {
+    return src->mapped + first_row * src->n;
+}
+
+void close_source(MatrixSource *src) {
+    if (src->mapped != NULL) munmap(src->mapped, src->mapped_size);
+}
+
+// Um bloco de linhas em andamento no pipeline. Há dois: enquanto um é
+// analisado, a comunicação do outro (o bloco seguinte) está em andamento
+typedef struct {
+    long long first_row;     // primeira linha deste rank no bloco
+    int rows;                // linhas deste rank no bloco
+    int *rows_data;          // linhas geradas ou lidas com MPI-IO
+    int32_t *encoded;        // arquivo cru: parte codificada recebida
+    int encoded_count;
+    int32_t *encoded_chunk;  // rank 0: partes de todos, codificadas
+    int *encoded_counts, *encoded_displs;
+    MPI_Request request;     // recepção/leitura do bloco ainda pendente
+} ChunkSlot;
+
+// Analisa `count` elementos em pedaços, chamando MPI_Test no pedido em
+// trânsito entre eles: sem thread de progresso, a maioria das implementações
+// MPI só avança uma operação não bloqueante dentro de chamadas MPI. Os
+// pedaços são múltiplos do bloco do kernel, então o resultado é o mesmo de
+// uma chamada só
+void reduce_with_progress(RunningStats *s, const int *v, long long count, MPI_Request *in_flight) {
+    for (long long i = 0; i < count; i += PROGRESS_ELEMENTS) {
+        long long len = count - i < PROGRESS_ELEMENTS ? count - i : PROGRESS_ELEMENTS;
+        stats_reduce_i32(s, v + i, len);
+        int done;
+        MPI_Test(in_flight, &done, MPI_STATUS_IGNORE);
     }
 }
 
@@ -33,83 +128,272 @@ int main(int argc, char *argv[]) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank); // Obtém o rank do processo atual
     MPI_Comm_size(MPI_COMM_WORLD, &size); // Obtém o número total de processos
 
-    int matrix[N][N]; // Matriz principal
-    int local_matrix[N / size][N]; // Parte da matriz distribuída para cada processo
-    int local_neg_count = 0, local_min = INT_MAX, local_max = INT_MIN; // Variáveis locais para contagem de negativos, valor mínimo e máximo - INT(_MAX) ou (_MIN) vienheram de limits.h e representa o maior e menor valor que uma var do tipo int pode armazenar
-    long long local_sum = 0; // Soma local dos elementos da matriz (long long foi utilizado para garantir que o s valores da matriz não excedam o intervalo de valores tipo int pode armazenar)
-    int local_zero_count = 0; // Contagem local de zeros
+    long long n = DEFAULT_N;
+    int chunk_rows = 0;
+    const char *filename = NULL, *output = NULL;
+    uint64_t seed = (uint64_t)time(NULL);
+    double zero_threshold = DEFAULT_ZERO_THRESHOLD;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:c:f:s:t:o:")) != -1) {
+        switch (opt) {
+        case 'n': n = atoll(optarg); break;
+        case 'c': chunk_rows = atoi(optarg); break;
+        case 'f': filename = optarg; break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 't': zero_threshold = atof(optarg); break;
+        case 'o': output = optarg; break;
+        default:
+            if (rank == 0) fprintf(stderr, "Usage: %s [-n N] [-c chunk_rows] [-f matrix] [-s seed] [-t zero_threshold] [-o out.mat]\n", argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
 
-    // Rank 0 gera a matriz e a distribui
-    if (rank == 0) {
-        generate_matrix(matrix);
-        printf("Matrix generated by rank 0\n");
+    // Com -f, o rank 0 olha o cabeçalho e todos ficam sabendo o formato e as
+    // dimensões; arquivos sem cabeçalho são tratados como int32 cru N x N
+    int source = SOURCE_GENERATED;
+    MatrixFileHeader header;
+    if (filename != NULL) {
+        int status = 0;
+        if (rank == 0) status = matrix_file_read_header(filename, &header);
+        MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (status < 0) {
+            if (rank == 0) fprintf(stderr, "Error opening %s\n", filename);
+            MPI_Finalize();
+            return 1;
+        }
+        source = status == 0 ? SOURCE_MATRIX_FILE : SOURCE_RAW_FILE;
+        MPI_Bcast(&header, sizeof(header), MPI_BYTE, 0, MPI_COMM_WORLD);
+    }
+    if (source != SOURCE_MATRIX_FILE) matrix_file_header_init(&header, n, n, MATRIX_INT32, 0);
+    if (source == SOURCE_MATRIX_FILE && header.dtype != MATRIX_INT32) {
+        if (rank == 0) fprintf(stderr, "%s: only int32 matrices are supported\n", filename);
+        MPI_Finalize();
+        return 1;
+    }
+    long long n_rows = header.rows, n_cols = header.cols;
+    if (chunk_rows == 0) chunk_rows = header.block_rows > 0 ? header.block_rows : DEFAULT_CHUNK_ROWS;
+
+    if (n_rows <= 0 || n_cols <= 0 || chunk_rows <= 0 || (long long)chunk_rows * n_cols > INT_MAX ||
+        size * sparse_encode_capacity(((long long)chunk_rows + size - 1) / size * n_cols) > INT_MAX) {
+        if (rank == 0) fprintf(stderr, "Invalid N or chunk size (chunk_rows * N must fit in an int)\n");
+        MPI_Finalize();
+        return 1;
+    }
+    if (chunk_rows > n_rows) chunk_rows = (int)n_rows;
+
+    // Todos usam a semente do rank 0 (o relógio pode diferir entre nós)
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    // Arquivo cru: o rank 0 é o único que lê a matriz, um bloco de cada vez
+    MatrixSource src;
+    if (rank == 0 && source == SOURCE_RAW_FILE && open_source(&src, filename, n) != 0) {
+        fprintf(stderr, "Error opening matrix source\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    // Formato de matriz: cada rank lê só as suas linhas. Num nó só, o arquivo
+    // é mapeado (o page cache é compartilhado e não há cópia); em vários nós,
+    // as leituras são coletivas com MPI-IO
+    MatrixMapping mapping = {NULL, 0, NULL};
+    MPI_File matrix_fh = MPI_FILE_NULL;
+    if (source == SOURCE_MATRIX_FILE) {
+        int err = 0;
+        if (matrix_file_single_node(MPI_COMM_WORLD))
+            err = matrix_file_map(filename, &header, &mapping) != 0;
+        else
+            err = MPI_File_open(MPI_COMM_WORLD, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &matrix_fh) != MPI_SUCCESS;
+        if (err) {
+            fprintf(stderr, "Rank %d: Error opening %s\n", rank, filename);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    // -o grava a matriz gerada no formato de matriz, cada rank as suas linhas
+    MPI_File output_fh = MPI_FILE_NULL;
+    if (output != NULL && source == SOURCE_GENERATED) {
+        MatrixFileHeader out_header;
+        matrix_file_header_init(&out_header, n_rows, n_cols, MATRIX_INT32, chunk_rows);
+        if (matrix_file_create(MPI_COMM_WORLD, output, &out_header, &output_fh) != MPI_SUCCESS) {
+            if (rank == 0) fprintf(stderr, "Error creating %s\n", output);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
     }
 
-    MPI_Barrier(MPI_COMM_WORLD); // Sincroniza todos os processos
-    printf("Rank %d reached barrier\n", rank);
-
-    // Distribui a matriz para todos os processos
-    MPI_Scatter(matrix, (N * N) / size, MPI_INT, local_matrix, (N * N) / size, MPI_INT, 0, MPI_COMM_WORLD);
-    // (N * N) / size: Número de elementos a serem enviados para cada processo. 
-    // local_matrix:  buffer de recepção em cada processo
-    // MPI_COMM_WORLD: O comunicador que define o grupo de processos envolvidos na operação.
-    printf("Rank %d completed scatter\n", rank);
-    /* É uma forma de comunicação coletiva onde um processo, conhecido como o "processo raiz", 
-    envia diferentes partes de um buffer para todos os outros processos.*/
-
-    // Cada processo calcula seus valores locais
-    for (int i = 0; i < N / size; i++) {
-        for (int j = 0; j < N; j++) {
-            int val = local_matrix[i][j];
-            if (val < 0) local_neg_count++;
-            if (val < local_min) local_min = val;
-            if (val > local_max) local_max = val;
-            local_sum += val;
-            if (val == 0) local_zero_count++;
+    // Cada rank recebe no máximo ceil(chunk_rows / size) linhas por rodada.
+    // Há dois conjuntos de buffers (double buffering): enquanto um bloco é
+    // analisado, a comunicação do seguinte já está em andamento
+    int max_local_rows = (chunk_rows + size - 1) / size;
+    long long encoded_capacity = sparse_encode_capacity((long long)max_local_rows * n_cols);
+    ChunkSlot slots[2];
+    int *sendcounts = (int *)malloc(size * sizeof(int));
+    int *displs = (int *)malloc(size * sizeof(int));
+    int alloc_failed = sendcounts == NULL || displs == NULL;
+    for (int b = 0; b < 2; b++) {
+        ChunkSlot *slot = &slots[b];
+        memset(slot, 0, sizeof(*slot));
+        slot->request = MPI_REQUEST_NULL;
+        slot->rows_data = (int *)malloc((size_t)max_local_rows * n_cols * sizeof(int));
+        alloc_failed |= slot->rows_data == NULL;
+        // No arquivo cru, cada parte vai pela rede já codificada (densa,
+        // bitmap ou CSR, conforme a fração de zeros) e é analisada sem ser
+        // expandida
+        if (source == SOURCE_RAW_FILE) {
+            slot->encoded = (int32_t *)malloc(encoded_capacity * sizeof(int32_t));
+            alloc_failed |= slot->encoded == NULL;
+            if (rank == 0) {
+                slot->encoded_chunk = (int32_t *)malloc(size * encoded_capacity * sizeof(int32_t));
+                slot->encoded_counts = (int *)malloc(size * sizeof(int));
+                slot->encoded_displs = (int *)malloc(size * sizeof(int));
+                alloc_failed |= slot->encoded_chunk == NULL || slot->encoded_counts == NULL ||
+                                slot->encoded_displs == NULL;
+            }
         }
     }
+    if (alloc_failed) {
+        fprintf(stderr, "Rank %d: Error allocating memory\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    long long wire_ints = 0, dense_ints = 0;
+
+    RunningStats local;
+    running_stats_init(&local);
+    double start = MPI_Wtime();
+
+    // Pipeline em dois estágios, defasados de um bloco: na volta k o bloco k
+    // é postado (MPI_Iscatterv ou MPI_File_iread_at_all, sem esperar) e o
+    // bloco k - 1, cujos dados já chegaram ou estão chegando, é analisado.
+    // Assim a transferência de um bloco fica escondida atrás da análise do
+    // anterior
+    long long n_chunks = (n_rows + chunk_rows - 1) / chunk_rows;
+    for (long long k = 0; k <= n_chunks; k++) {
+        if (k < n_chunks) {
+            ChunkSlot *slot = &slots[k % 2];
+            long long first_row = k * chunk_rows;
+            int rows = (int)(n_rows - first_row < chunk_rows ? n_rows - first_row : chunk_rows);
 
-    int global_neg_count, global_min, global_max, global_zero_count;
-    long long global_sum;
-    double mean; // Media
+            // Divisão desigual: os primeiros rows % size ranks recebem uma
+            // linha a mais, então nenhuma linha é descartada quando
+            // N % size != 0
+            int offset = 0;
+            for (int r = 0; r < size; r++) {
+                int r_rows = rows / size + (r < rows % size ? 1 : 0);
+                sendcounts[r] = r_rows * (int)n_cols;
+                displs[r] = offset;
+                offset += sendcounts[r];
+            }
+            slot->first_row = first_row + displs[rank] / n_cols;
+            slot->rows = sendcounts[rank] / (int)n_cols;
 
-    // Reduz os valores locais para os valores globais
-    MPI_Reduce(&local_neg_count, &global_neg_count, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_min, &global_min, 1, MPI_INT, MPI_MIN, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_max, &global_max, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_sum, &global_sum, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_zero_count, &global_zero_count, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-    
-    // A função Reduce combina valores de todos os processos em um único valor agregado no processo raiz
+            if (source == SOURCE_RAW_FILE) {
+                // Rank 0 codifica a parte de cada rank numa única leitura do
+                // mapeamento; só o tamanho codificado passa pela rede. Os
+                // tamanhos vão antes (mensagem pequena, bloqueante) porque o
+                // MPI_Iscatterv precisa deles para ser postado
+                if (rank == 0) {
+                    const int *chunk = source_rows(&src, first_row);
+                    int encoded_offset = 0;
+                    for (int r = 0; r < size; r++) {
+                        slot->encoded_displs[r] = encoded_offset;
+                        slot->encoded_counts[r] = (int)sparse_encode(chunk + displs[r], sendcounts[r] / (int)n_cols,
+                                                                     (int)n_cols, zero_threshold,
+                                                                     slot->encoded_chunk + encoded_offset);
+                        encoded_offset += slot->encoded_counts[r];
+                    }
+                    wire_ints += encoded_offset;
+                    dense_ints += offset;
+                }
+                MPI_Scatter(slot->encoded_counts, 1, MPI_INT, &slot->encoded_count, 1, MPI_INT, 0, MPI_COMM_WORLD);
+                MPI_Iscatterv(slot->encoded_chunk, slot->encoded_counts, slot->encoded_displs, MPI_INT,
+                              slot->encoded, slot->encoded_count, MPI_INT, 0, MPI_COMM_WORLD, &slot->request);
+            } else if (source == SOURCE_MATRIX_FILE && mapping.base == NULL) {
+                matrix_file_iread_rows(matrix_fh, &header, slot->first_row, slot->rows, slot->rows_data,
+                                       &slot->request);
+            }
+        }
 
+        if (k > 0) {
+            ChunkSlot *slot = &slots[(k - 1) % 2];
+            MPI_Request *in_flight = &slots[k % 2].request; // MPI_REQUEST_NULL na última volta
+            MPI_Wait(&slot->request, MPI_STATUS_IGNORE);
+            long long elements = (long long)slot->rows * n_cols;
 
-    mean = (double)global_sum / (N * N); // Calcula a média dos elementos
+            if (source == SOURCE_RAW_FILE) {
+                // Só os valores armazenados são lidos (contíguos em todos os
+                // formatos), em pedaços com MPI_Test entre eles como no
+                // arquivo de matriz; zeros entram pela contagem, como em
+                // sparse_block_stats
+                long long stored;
+                const int32_t *values = sparse_block_values(slot->encoded, &stored);
+                reduce_with_progress(&local, values, stored, in_flight);
+                if (slot->encoded[0] != SPARSE_DENSE)
+                    running_stats_add_zeros(&local, elements - slot->encoded[3]);
+            } else if (source == SOURCE_MATRIX_FILE) {
+                const int *mine = slot->rows_data;
+                if (mapping.base != NULL)
+                    mine = (const int *)matrix_file_mapped_row(&mapping, &header, slot->first_row);
+                reduce_with_progress(&local, mine, elements, in_flight);
+            } else {
+                // Matriz gerada: cada rank produz só as suas linhas do bloco
+                generate_rows(slot->rows_data, n_cols, slot->first_row, slot->rows, seed);
+                if (output_fh != MPI_FILE_NULL)
+                    matrix_file_write_rows(output_fh, &header, slot->first_row, slot->rows, slot->rows_data);
 
-    double local_variance_sum = 0.0; // Soma local da variância
-    for (int i = 0; i < N / size; i++) {
-        for (int j = 0; j < N; j++) {
-            local_variance_sum += pow(local_matrix[i][j] - mean, 2); // Calcula a diferença ao quadrado da média
+                // Passe único: contagens, extremos, média e M2 na mesma leitura
+                stats_reduce_i32(&local, slot->rows_data, elements);
+            }
+            int done;
+            MPI_Test(in_flight, &done, MPI_STATUS_IGNORE);
         }
     }
 
-    double global_variance_sum;
-    // Reduz a soma das variâncias locais para a soma global
-    MPI_Reduce(&local_variance_sum, &global_variance_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    // Uma única redução com a operação definida pelo usuário substitui as
+    // cinco chamadas de MPI_Reduce (negativos, mínimo, máximo, soma, zeros).
+    // Ela é hierárquica (common/node_reduce.h): os ranks de cada nó se
+    // combinam por uma janela de memória compartilhada e só um líder por nó
+    // entra na redução entre nós
+    NodeReducer reducer;
+    node_reduce_init(&reducer, MPI_COMM_WORLD);
+    RunningStats global;
+    node_reduce(&reducer, &local, &global);
+    node_reduce_free(&reducer);
+    double elapsed = MPI_Wtime() - start;
+
+    if (output_fh != MPI_FILE_NULL) MPI_File_close(&output_fh);
+    if (matrix_fh != MPI_FILE_NULL) MPI_File_close(&matrix_fh);
+    matrix_file_unmap(&mapping);
 
     // Rank 0 exibe os resultados
     if (rank == 0) {
-        double stddev = sqrt(global_variance_sum / (N * N)); // Calcula o desvio padrão
+        long long total = global.count;
+        double stddev = sqrt(running_stats_variance(&global)); // Calcula o desvio padrão
 
-        printf("Contagem de elementos negativos: %d\n", global_neg_count);
-        printf("Menor valor: %d\n", global_min);
-        printf("Maior valor: %d\n", global_max);
-        printf("Média: %.2f\n", mean);
+        printf("Elementos analisados: %lld (%lldx%lld)\n", total, n_rows, n_cols);
+        if (source == SOURCE_GENERATED) printf("Semente: %llu\n", (unsigned long long)seed);
+        printf("Contagem de elementos negativos: %lld\n", global.negatives);
+        printf("Menor valor: %.0f\n", global.min);
+        printf("Maior valor: %.0f\n", global.max);
+        printf("Média: %.2f\n", global.mean);
         printf("Desvio padrão: %.2f\n", stddev);
-        printf("Número de ocorrências do valor zero: %d\n", global_zero_count);
-        printf("A matriz é %sesparsa.\n", (global_zero_count > (N * N) / 2) ? "" : "não ");
+        printf("Número de ocorrências do valor zero: %lld\n", global.zeros);
+        printf("A matriz é %sesparsa.\n", (global.zeros > total / 2) ? "" : "não ");
+        printf("Tempo: %.3f s (%.2f GB/s)\n", elapsed, total * sizeof(int) / elapsed / 1e9);
+        if (source == SOURCE_RAW_FILE) {
+            printf("Dados enviados: %.2f MB (denso seria %.2f MB)\n",
+                   wire_ints * sizeof(int32_t) / 1e6, dense_ints * sizeof(int32_t) / 1e6);
+            close_source(&src);
+        }
     }
 
+    for (int b = 0; b < 2; b++) {
+        free(slots[b].rows_data);
+        free(slots[b].encoded);
+        free(slots[b].encoded_chunk);
+        free(slots[b].encoded_counts);
+        free(slots[b].encoded_displs);
+    }
+    free(sendcounts);
+    free(displs);
     MPI_Finalize(); // Finaliza o ambiente MPI
     return 0;
 }
-
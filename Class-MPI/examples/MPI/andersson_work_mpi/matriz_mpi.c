@@ -1,15 +1,26 @@
+// Comando para gerar o executável:
+// g++ -O3 -march=native -fopenmp-simd -c ../../../../common/stats_kernels.cpp
+// mpicc -O3 -march=native -I../../../../common matriz_mpi.c -o trabalho_MPI_andersson stats_kernels.o -lm
+
 #include <mpi.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
+#include <stdint.h>
+#include "running_stats.h"
+#include "node_reduce.h"   // redução hierárquica por nó (pasta common/)
+#include "philox.h"        // gerador baseado em contador (pasta common/)
+#include "stats_kernels.h" // kernels SIMD (AVX2/AVX-512) da pasta common/
 
 #define N 1000
 
-void generate_matrix(int *matrix, int size) {
-    for (int i = 0; i < size; i++) {
-        matrix[i] = (rand() % 201) - 100;
-    }
+// Gera as linhas [first_row, first_row + rows) da matriz com valores entre
+// -100 e 100. Cada elemento depende só do seu índice global e da semente,
+// então cada rank gera o seu bloco e o resultado não muda com o número de
+// processos
+void generate_rows(int *rows_data, long long first_row, int rows, uint64_t seed) {
+    philox_fill_ints(rows_data, (uint64_t)first_row * N, (long long)rows * N, seed, -100, 100);
 }
 
 int main(int argc, char **argv) {
@@ -18,63 +29,48 @@ int main(int argc, char **argv) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    int *matrix = NULL;
-    int *local_matrix = (int *)malloc(N * N / size * sizeof(int));
-
-    if (rank == 0) {
-        matrix = (int *)malloc(N * N * sizeof(int));
-        srand(time(NULL));
-        generate_matrix(matrix, N * N);
-    }
-
-    MPI_Scatter(matrix, N * N / size, MPI_INT, local_matrix, N * N / size, MPI_INT, 0, MPI_COMM_WORLD);
-
-    int local_negative_count = 0, local_zero_count = 0;
-    long long local_sum = 0;
+    // Semente opcional na linha de comando (para repetir uma execução);
+    // senão o rank 0 sorteia pelo relógio e envia para os demais
+    uint64_t seed = 0;
+    if (rank == 0) seed = argc > 1 ? strtoull(argv[1], NULL, 10) : (uint64_t)time(NULL);
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
 
-    int local_max = local_matrix[0];
-    int local_min = local_matrix[0];
+    // Divisão por linhas: os primeiros N % size ranks ficam com uma a mais
+    int local_rows = N / size + (rank < N % size ? 1 : 0);
+    long long first_row = (long long)rank * (N / size) + (rank < N % size ? rank : N % size);
+    int *local_matrix = (int *)malloc((size_t)local_rows * N * sizeof(int));
+    generate_rows(local_matrix, first_row, local_rows, seed);
 
-    for (int i = 0; i < N * N / size; i++) {
-        if (local_matrix[i] < 0) local_negative_count++;
-        if (local_matrix[i] == 0) local_zero_count++;
-        if (local_matrix[i] > local_max) local_max = local_matrix[i];
-        if (local_matrix[i] < local_min) local_min = local_matrix[i];
-        local_sum += local_matrix[i];
-    }
+    // Um passe só sobre o bloco local: contagens, extremos, média e M2
+    RunningStats local_stats, global_stats;
+    running_stats_init(&local_stats);
+    stats_reduce_i32(&local_stats, local_matrix, (long long)local_rows * N);
 
-    int global_negative_count, global_zero_count;
-    int global_max, global_min;
-    long long global_sum;
-    MPI_Reduce(&local_negative_count, &global_negative_count, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_zero_count, &global_zero_count, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_max, &global_max, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_min, &global_min, 1, MPI_INT, MPI_MIN, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_sum, &global_sum, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    // Uma redução só, com a fórmula de Chan, no lugar das cinco anteriores e
+    // do segundo passe serial do rank 0 para a variância. É hierárquica:
+    // combina dentro do nó por memória compartilhada e só os líderes de cada
+    // nó trocam mensagens
+    NodeReducer reducer;
+    node_reduce_init(&reducer, MPI_COMM_WORLD);
+    node_reduce(&reducer, &local_stats, &global_stats);
+    node_reduce_free(&reducer);
 
     if (rank == 0) {
-        double mean = (double)global_sum / (N * N);
-        double variance_sum = 0.0;
-
-        for (int i = 0; i < N * N; i++) {
-            variance_sum += (matrix[i] - mean) * (matrix[i] - mean);
-        }
-
-        double stddev = sqrt(variance_sum / (N * N));
+        double mean = global_stats.mean;
+        double stddev = sqrt(running_stats_variance(&global_stats));
 
-        printf("Número de elementos negativos: %d\n", global_negative_count);
-        printf("Maior valor: %d\n", global_max);
-        printf("Menor valor: %d\n", global_min);
+        printf("Semente: %llu\n", (unsigned long long)seed);
+        printf("Número de elementos negativos: %lld\n", global_stats.negatives);
+        printf("Maior valor: %.0f\n", global_stats.max);
+        printf("Menor valor: %.0f\n", global_stats.min);
         printf("Média: %f\n", mean);
         printf("Desvio Padrão: %f\n", stddev);
-        printf("Número de zeros: %d\n", global_zero_count);
+        printf("Número de zeros: %lld\n", global_stats.zeros);
         
-        if (global_zero_count > (N * N) / 2)
+        if (global_stats.zeros > global_stats.count / 2)
             printf("A matriz é esparsa.\n");
         else
             printf("A matriz não é esparsa.\n");
-    
-        free(matrix);
     }
 
     free(local_matrix);
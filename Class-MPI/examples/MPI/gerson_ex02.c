@@ -1,6 +1,18 @@
+#include <stdio.h>
+#include <mpi.h>
+
+// Anel: o rank 0 envia um token para o 1, cada rank soma o seu rank e
+// repassa para o próximo, e o último devolve para o 0. Totalmente serial:
+// só um processo trabalha por vez. A versão com o buffer dividido em
+// pedaços que circulam todos juntos (allreduce em anel) está em
+// common/ring_allreduce.h e ring_allreduce/ring_bench.c
+//
+// mpicc gerson_ex02.c -o gerson_ex02
+// mpirun -np 4 ./gerson_ex02
 int emParalelo( int myR, int worldSize ) {
-int aux;
+int aux, dest;
 MPI_Status st;
+if( worldSize == 1 ) return myR; // sem vizinhos: o anel é só o rank 0
 if( myR == 0 ) {
 MPI_Send((void*)&myR, 1, MPI_INT, myR+1, 0, MPI_COMM_WORLD);
 MPI_Recv(&aux, 1, MPI_INT, worldSize-1, MPI_ANY_TAG, MPI_COMM_WORLD, &st);
@@ -12,3 +24,16 @@ MPI_Send(&aux, 1, MPI_INT, dest, 0, MPI_COMM_WORLD);
 }
 return aux+myR; // Será descartado quando myRank != 0
 }
+
+int main(int argc, char** argv) {
+int worldSize, myRank, soma;
+MPI_Init(&argc, &argv); // Inicialização
+MPI_Comm_size(MPI_COMM_WORLD, &worldSize); // Quantos processos envolvidos?
+MPI_Comm_rank(MPI_COMM_WORLD, &myRank); // Meu identificador
+soma = emParalelo(myRank, worldSize);
+if( myRank == 0 ) {
+printf("Soma dos ranks pelo anel: %d (esperado %d)\n", soma, worldSize*(worldSize-1)/2);
+}
+MPI_Finalize(); // Finalização
+return 0;
+}
@@ -0,0 +1,175 @@
+// Benchmark dos backends de common/matrix_stats.hpp sobre a mesma matriz.
+//
+// Comando para gerar o executável: make
+// Comando para executar:
+//   mpirun -np 4 ./matrix_stats_bench                 (4096x4096 int32)
+//   mpirun -np 2 ./matrix_stats_bench -n 8192 -d double -t 4 -r 10
+//   mpirun -np 8 ./matrix_stats_bench -N 2     (emula nós de 2 ranks)
+//
+// A matriz é gerada com Philox (common/philox.h): o rank 0 gera a matriz
+// inteira para os backends serial e OpenMP, e cada rank gera só a sua fatia
+// de linhas para os backends MPI. Como cada elemento depende só do índice e
+// da semente, todos os backends analisam exatamente os mesmos dados e os
+// resultados são conferidos contra o serial.
+//
+// Os backends "-hier" combinam primeiro dentro do nó (common/node_reduce.h)
+// e são conferidos também contra a redução plana correspondente. Numa
+// máquina só todos os ranks caem no mesmo nó; -N agrupa os ranks em nós
+// emulados de N ranks para exercitar a redução entre líderes.
+
+#include <mpi.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+#include "philox.h"
+#include "matrix_stats.hpp"
+
+struct Options {
+    long long n = 4096;
+    int reps = 5;
+    int threads = 0;
+    int ranks_per_node = 0;
+    uint64_t seed = 42;
+    const char *dtype = "int32";
+};
+
+// Linhas [first_row, first_row + rows) da matriz n x n, convertidas para T
+template <class T>
+std::vector<T> generate(long long n, long long first_row, long long rows, uint64_t seed) {
+    std::vector<int> ints(rows * n);
+    philox_fill_ints(ints.data(), (uint64_t)first_row * n, rows * n, seed, -1000, 1000);
+    return std::vector<T>(ints.begin(), ints.end());
+}
+
+// Mesmo resultado que o serial: contagens e extremos exatos, média e M2 a
+// menos do arredondamento da ordem de combinação
+bool same_result(const RunningStats &a, const RunningStats &b) {
+    return a.count == b.count && a.negatives == b.negatives && a.zeros == b.zeros &&
+           a.min == b.min && a.max == b.max &&
+           std::fabs(a.mean - b.mean) <= 1e-9 * (1.0 + std::fabs(b.mean)) &&
+           std::fabs(a.m2 - b.m2) <= 1e-9 * b.m2;
+}
+
+// Melhor tempo de `reps` execuções; nos backends MPI conta o rank mais lento
+template <class Backend, class T>
+double best_time(const Backend &backend, const std::vector<T> &data, int reps, RunningStats *result) {
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        *result = stats::analyze(backend, data.data(), data.size());
+        double elapsed = MPI_Wtime() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+template <class T>
+void run(const Options &opt, int rank, int size) {
+    long long n = opt.n;
+    long long my_rows = n / size + (rank < n % size ? 1 : 0);
+    long long my_first = rank * (n / size) + (rank < n % size ? rank : n % size);
+    double bytes = (double)n * n * sizeof(T);
+
+    stats::Serial serial;
+    stats::OpenMP openmp;
+    openmp.threads = opt.threads;
+    stats::Distributed<stats::Serial> mpi;
+    stats::Distributed<stats::OpenMP> hybrid;
+    hybrid.node.threads = opt.threads;
+    stats::Hierarchical<stats::Serial> mpi_hier(MPI_COMM_WORLD, opt.ranks_per_node);
+    stats::Hierarchical<stats::OpenMP> hybrid_hier(MPI_COMM_WORLD, opt.ranks_per_node);
+    hybrid_hier.node.threads = opt.threads;
+
+    RunningStats reference, result, flat;
+    running_stats_init(&reference);
+    running_stats_init(&result);
+    running_stats_init(&flat);
+    if (rank == 0) {
+        std::printf("Matriz %lldx%lld %s (%.1f MB), %d processos, %d repetições\n",
+                    n, n, opt.dtype, bytes / 1e6, size, opt.reps);
+        std::printf("%-12s %12s %10s %10s %12s %12s %s\n",
+                    "backend", "tempo (ms)", "GB/s", "speedup", "média", "desvio", "confere");
+    }
+
+    auto report = [&](const char *name, double seconds, const RunningStats &s, double serial_seconds,
+                      const RunningStats &expected) {
+        std::printf("%-12s %12.3f %10.2f %10.2f %12.4f %12.4f %s\n", name, seconds * 1e3,
+                    bytes / seconds / 1e9, serial_seconds / seconds, s.mean,
+                    std::sqrt(running_stats_variance(&s)),
+                    same_result(s, reference) && same_result(s, expected) ? "sim" : "NÃO");
+    };
+
+    // Serial e OpenMP: a matriz inteira num processo só
+    double serial_seconds = 0.0;
+    {
+        std::vector<T> whole;
+        if (rank == 0) whole = generate<T>(n, 0, n, opt.seed);
+        double t = best_time(serial, whole, opt.reps, &reference);
+        if (rank == 0) {
+            serial_seconds = t;
+            report(serial.name(), t, reference, serial_seconds, reference);
+        }
+        t = best_time(openmp, whole, opt.reps, &result);
+        if (rank == 0) report(openmp.name(), t, result, serial_seconds, reference);
+    }
+
+    // MPI e MPI+OpenMP: cada rank só com a sua fatia. Cada backend
+    // hierárquico é conferido também contra o plano que o precede
+    std::vector<T> slice = generate<T>(n, my_first, my_rows, opt.seed);
+    auto distributed = [&](const auto &backend, const RunningStats &expected) {
+        double t = best_time(backend, slice, opt.reps, &result);
+        MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        if (rank == 0) report(backend.name(), t, result, serial_seconds, expected);
+    };
+    distributed(mpi, reference);
+    flat = result;
+    distributed(mpi_hier, flat);
+    distributed(hybrid, reference);
+    flat = result;
+    distributed(hybrid_hier, flat);
+}
+
+int main(int argc, char *argv[]) {
+    int provided, rank, size;
+    // Só a thread principal chama MPI; as regiões OpenMP ficam entre chamadas
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    Options opt;
+    int c;
+    while ((c = getopt(argc, argv, "n:r:t:N:s:d:")) != -1) {
+        switch (c) {
+        case 'n': opt.n = std::atoll(optarg); break;
+        case 'r': opt.reps = std::atoi(optarg); break;
+        case 't': opt.threads = std::atoi(optarg); break;
+        case 'N': opt.ranks_per_node = std::atoi(optarg); break;
+        case 's': opt.seed = std::strtoull(optarg, nullptr, 10); break;
+        case 'd': opt.dtype = optarg; break;
+        default:
+            if (rank == 0)
+                std::fprintf(stderr, "Usage: %s [-n N] [-r reps] [-t threads] [-N ranks/nó] [-s seed] [-d int32|int64|float|double]\n", argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    if (opt.n <= 0 || opt.reps <= 0) {
+        if (rank == 0) std::fprintf(stderr, "Invalid N or repetition count\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (std::strcmp(opt.dtype, "int32") == 0) run<std::int32_t>(opt, rank, size);
+    else if (std::strcmp(opt.dtype, "int64") == 0) run<std::int64_t>(opt, rank, size);
+    else if (std::strcmp(opt.dtype, "float") == 0) run<float>(opt, rank, size);
+    else if (std::strcmp(opt.dtype, "double") == 0) run<double>(opt, rank, size);
+    else if (rank == 0) std::fprintf(stderr, "Unknown type %s\n", opt.dtype);
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,274 @@
+// Microbenchmarks MPI no estilo OSU: ping-pong (latência e banda), Bcast,
+// Scatter, Gather, Reduce e Barrier, em vários tamanhos de mensagem.
+//
+// O hello_mpi.c, o mpi_hello.c, o mpi_frank.c e o gerson_ex01.c só mostram
+// rank e computador; aqui o MPI_Get_processor_name é usado para saber onde
+// cada rank está e separar os números intra-nó (memória compartilhada) dos
+// entre nós (rede):
+//  - ping-pong entre o rank 0 e o primeiro rank no mesmo computador e entre
+//    o rank 0 e o primeiro rank em outro computador (n/d se não houver);
+//  - coletivas em MPI_COMM_WORLD e, se os ranks estão em mais de um nó e
+//    algum nó tem mais de um rank, também só dentro de cada nó.
+//
+// Para escolher entre os desenhos com MPI_Scatter (o processo 0 lê a matriz
+// e distribui) e em faixas (cada processo lê a sua parte do arquivo): o
+// tempo da linha Scatter no tamanho da faixa de cada processo é o que o
+// primeiro paga a mais; compare com o tempo de leitura e de cálculo da faixa.
+//
+// Comando para gerar o executável: make
+// Comando para executar:
+//   mpirun -np 2 ./osu_bench                               (1 B a 1 MiB)
+//   mpirun -np 8 -hosts worker1,worker2 ./osu_bench -m 16  (até 16 MiB, intra-nó e entre nós)
+//   mpirun -np 4 ./osu_bench -i 10000 -w 128
+//
+// Detalhes:
+//  - latência = metade do tempo de ida e volta, média de -i iterações (um
+//    décimo disso acima de LARGE_MESSAGE bytes), depois de um aquecimento;
+//  - banda = janela de -w MPI_Isend seguidos de uma confirmação, como o
+//    osu_bw: mede a vazão com várias mensagens em voo;
+//  - coletivas: tempo médio por chamada em cada rank; a tabela mostra a
+//    média, o mínimo e o máximo entre os ranks. Scatter e Gather usam o
+//    tamanho por rank (o root envia ou recebe p vezes isso); Reduce soma
+//    floats (MPI_SUM) e começa em 4 bytes.
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_MAX_KB 1024   // maior mensagem padrão: 1 MiB
+#define DEFAULT_ITERS 1000    // iterações por tamanho nas mensagens pequenas
+#define DEFAULT_WINDOW 64     // mensagens em voo no teste de banda
+#define LARGE_MESSAGE 8192    // acima disso, um décimo das iterações
+#define TAG_DATA 1
+#define TAG_ACK 2
+
+typedef enum { BCAST, SCATTER, GATHER, REDUCE, BARRIER, NUM_COLLECTIVES } Collective;
+static const char *collective_names[NUM_COLLECTIVES] = {"Bcast", "Scatter", "Gather", "Reduce", "Barrier"};
+
+static int iterations(long bytes, int iters) {
+    int n = bytes > LARGE_MESSAGE ? iters / 10 : iters;
+    return n < 10 ? 10 : n;
+}
+
+// Ping-pong entre os ranks a e b do comm; devolve a latência em segundos
+// (metade da ida e volta) no rank a, 0 nos outros
+static double pingpong(MPI_Comm comm, int a, int b, char *buf, long bytes, int iters) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    int warmup = iters / 10;
+    double start = 0.0;
+    for (int i = 0; i < warmup + iters; i++) {
+        if (i == warmup) start = MPI_Wtime();
+        if (rank == a) {
+            MPI_Send(buf, (int)bytes, MPI_CHAR, b, TAG_DATA, comm);
+            MPI_Recv(buf, (int)bytes, MPI_CHAR, b, TAG_DATA, comm, MPI_STATUS_IGNORE);
+        } else if (rank == b) {
+            MPI_Recv(buf, (int)bytes, MPI_CHAR, a, TAG_DATA, comm, MPI_STATUS_IGNORE);
+            MPI_Send(buf, (int)bytes, MPI_CHAR, a, TAG_DATA, comm);
+        }
+    }
+    return rank == a ? (MPI_Wtime() - start) / (2.0 * iters) : 0.0;
+}
+
+// Banda de a para b com `window` mensagens em voo; devolve bytes/s no rank a
+static double bandwidth(MPI_Comm comm, int a, int b, char *buf, long bytes, int iters, int window,
+                        MPI_Request *req) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    int warmup = iters / 10;
+    char ack = 0;
+    double start = 0.0;
+    for (int i = 0; i < warmup + iters; i++) {
+        if (i == warmup) start = MPI_Wtime();
+        if (rank == a) {
+            for (int w = 0; w < window; w++) MPI_Isend(buf, (int)bytes, MPI_CHAR, b, TAG_DATA, comm, &req[w]);
+            MPI_Waitall(window, req, MPI_STATUSES_IGNORE);
+            MPI_Recv(&ack, 1, MPI_CHAR, b, TAG_ACK, comm, MPI_STATUS_IGNORE);
+        } else if (rank == b) {
+            // Todas as mensagens vão para o mesmo buffer: só o tempo importa
+            for (int w = 0; w < window; w++) MPI_Irecv(buf, (int)bytes, MPI_CHAR, a, TAG_DATA, comm, &req[w]);
+            MPI_Waitall(window, req, MPI_STATUSES_IGNORE);
+            MPI_Send(&ack, 1, MPI_CHAR, a, TAG_ACK, comm);
+        }
+    }
+    return rank == a ? (double)bytes * window * iters / (MPI_Wtime() - start) : 0.0;
+}
+
+static void run_collective(Collective kind, MPI_Comm comm, char *buf, char *root_buf, long bytes) {
+    switch (kind) {
+    case BCAST: MPI_Bcast(buf, (int)bytes, MPI_CHAR, 0, comm); break;
+    case SCATTER: MPI_Scatter(root_buf, (int)bytes, MPI_CHAR, buf, (int)bytes, MPI_CHAR, 0, comm); break;
+    case GATHER: MPI_Gather(buf, (int)bytes, MPI_CHAR, root_buf, (int)bytes, MPI_CHAR, 0, comm); break;
+    case REDUCE: MPI_Reduce(buf, root_buf, (int)(bytes / sizeof(float)), MPI_FLOAT, MPI_SUM, 0, comm); break;
+    default: MPI_Barrier(comm); break;
+    }
+}
+
+// Tempo médio por chamada neste rank; a barreira antes de cada chamada
+// impede que um root rápido emende chamadas e esconda a latência
+static double time_collective(Collective kind, MPI_Comm comm, char *buf, char *root_buf, long bytes, int iters) {
+    int warmup = iters / 10;
+    double total = 0.0;
+    for (int i = 0; i < warmup + iters; i++) {
+        MPI_Barrier(comm);
+        double start = MPI_Wtime();
+        run_collective(kind, comm, buf, root_buf, bytes);
+        if (i >= warmup) total += MPI_Wtime() - start;
+    }
+    return total / iters;
+}
+
+// Média, mínimo e máximo de `t` entre os ranks de MPI_COMM_WORLD (no rank 0)
+static void world_stats(double t, double *avg, double *min, double *max) {
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Reduce(&t, avg, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&t, min, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&t, max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    *avg /= size;
+}
+
+static void collectives(const char *scope, MPI_Comm comm, char *buf, char *root_buf, long max_bytes, int iters) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    for (int kind = 0; kind < NUM_COLLECTIVES; kind++) {
+        if (rank == 0) {
+            printf("\n# %s, %s (us por chamada entre os ranks)\n", collective_names[kind], scope);
+            if (kind != BARRIER) printf("%12s %11s %11s %11s\n", "bytes/rank", "média", "mínimo", "máximo");
+            else printf("%12s %11s %11s %11s\n", "", "média", "mínimo", "máximo");
+        }
+        long first = kind == REDUCE ? (long)sizeof(float) : 1;
+        for (long bytes = first; bytes <= max_bytes; bytes *= 2) {
+            double avg, min, max;
+            double t = time_collective(kind, comm, buf, root_buf, bytes, iterations(bytes, iters));
+            world_stats(t, &avg, &min, &max);
+            if (rank == 0) {
+                if (kind != BARRIER) printf("%12ld", bytes);
+                else printf("%12s", "");
+                printf(" %11.2f %11.2f %11.2f\n", avg * 1e6, min * 1e6, max * 1e6);
+            }
+            if (kind == BARRIER) break;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int rank, size, namelen;
+    char hostname[MPI_MAX_PROCESSOR_NAME];
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Get_processor_name(hostname, &namelen);
+
+    long max_kb = DEFAULT_MAX_KB;
+    int iters = DEFAULT_ITERS, window = DEFAULT_WINDOW, opt;
+    while ((opt = getopt(argc, argv, "m:i:w:")) != -1) {
+        switch (opt) {
+        case 'm': max_kb = (long)(atof(optarg) * 1024); break;
+        case 'i': iters = atoi(optarg); break;
+        case 'w': window = atoi(optarg); break;
+        default:
+            if (rank == 0) fprintf(stderr, "Usage: %s [-m max_MiB] [-i iterations] [-w window]\n", argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    long max_bytes = max_kb << 10;
+    if (max_bytes < 1 || (long long)max_bytes * size > 0x7FFFFFFF || iters <= 0 || window <= 0) {
+        if (rank == 0) fprintf(stderr, "Invalid message size, iteration count or window\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Posicionamento: todos os nomes em todos os ranks; o nó de cada rank é o
+    // menor rank com o mesmo nome
+    char *names = malloc((size_t)size * MPI_MAX_PROCESSOR_NAME);
+    if (names == NULL) {
+        fprintf(stderr, "Rank %d: Error allocating processor names\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Allgather(hostname, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, names, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                  MPI_COMM_WORLD);
+    int my_node = 0, nodes = 0, intra_peer = -1, inter_peer = -1, max_per_node = 0;
+    for (int r = 0; r < size; r++) {
+        const char *name = names + (size_t)r * MPI_MAX_PROCESSOR_NAME;
+        int first = 0;
+        while (strcmp(names + (size_t)first * MPI_MAX_PROCESSOR_NAME, name) != 0) first++;
+        if (first == r) nodes++;
+        if (r == rank) my_node = first;
+        int same_as_0 = strcmp(name, names) == 0;
+        if (r > 0 && same_as_0 && intra_peer < 0) intra_peer = r;
+        if (!same_as_0 && inter_peer < 0) inter_peer = r;
+        int on_node = 0;
+        for (int q = 0; q < size; q++) on_node += strcmp(names + (size_t)q * MPI_MAX_PROCESSOR_NAME, name) == 0;
+        if (on_node > max_per_node) max_per_node = on_node;
+    }
+
+    if (rank == 0) {
+        printf("%d processos em %d nó(s)\n", size, nodes);
+        for (int r = 0; r < size; r++) printf("  rank %3d: %s\n", r, names + (size_t)r * MPI_MAX_PROCESSOR_NAME);
+        printf("Ping-pong intra-nó: rank 0 <-> ");
+        if (intra_peer >= 0) printf("rank %d", intra_peer);
+        else printf("n/d");
+        printf(", entre nós: rank 0 <-> ");
+        if (inter_peer >= 0) printf("rank %d\n", inter_peer);
+        else printf("n/d\n");
+    }
+
+    char *buf = malloc(max_bytes);
+    char *root_buf = malloc((size_t)max_bytes * size);
+    MPI_Request *req = malloc(window * sizeof(MPI_Request));
+    if (buf == NULL || root_buf == NULL || req == NULL) {
+        fprintf(stderr, "Rank %d: Error allocating buffers\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    // Floats pequenos: o Reduce soma valores válidos
+    for (long i = 0; i < max_bytes / (long)sizeof(float); i++) ((float *)buf)[i] = 1.0f;
+    memset(root_buf, 0, (size_t)max_bytes * size);
+
+    // Ping-pong e banda: só o par mede; os outros ranks esperam na barreira
+    const int peers[2] = {intra_peer, inter_peer};
+    if (rank == 0) {
+        printf("\n# Ponto a ponto (latência = metade da ida e volta; banda com janela de %d)\n", window);
+        printf("%12s %13s %13s %13s %13s\n", "bytes", "intra (us)", "intra (MB/s)", "entre (us)", "entre (MB/s)");
+    }
+    for (long bytes = 1; bytes <= max_bytes; bytes *= 2) {
+        int n = iterations(bytes, iters);
+        double lat[2] = {0.0, 0.0}, bw[2] = {0.0, 0.0};
+        for (int p = 0; p < 2; p++) {
+            if (peers[p] < 0) continue;
+            MPI_Barrier(MPI_COMM_WORLD);
+            lat[p] = pingpong(MPI_COMM_WORLD, 0, peers[p], buf, bytes, n);
+            MPI_Barrier(MPI_COMM_WORLD);
+            bw[p] = bandwidth(MPI_COMM_WORLD, 0, peers[p], buf, bytes, n, window, req);
+        }
+        if (rank == 0) {
+            printf("%12ld", bytes);
+            for (int p = 0; p < 2; p++) {
+                if (peers[p] < 0) printf(" %13s %13s", "n/d", "n/d");
+                else printf(" %13.2f %13.1f", lat[p] * 1e6, bw[p] / 1e6);
+            }
+            printf("\n");
+        }
+    }
+
+    collectives(nodes == 1 ? "MPI_COMM_WORLD, intra-nó" : "MPI_COMM_WORLD, entre nós", MPI_COMM_WORLD, buf, root_buf,
+                max_bytes, iters);
+    if (nodes > 1 && max_per_node > 1) {
+        // Só intra-nó: um comunicador por computador, todos medindo ao mesmo tempo
+        MPI_Comm node;
+        MPI_Comm_split(MPI_COMM_WORLD, my_node, rank, &node);
+        collectives("dentro de cada nó", node, buf, root_buf, max_bytes, iters);
+        MPI_Comm_free(&node);
+    }
+
+    free(names);
+    free(buf);
+    free(root_buf);
+    free(req);
+    MPI_Finalize();
+    return 0;
+}
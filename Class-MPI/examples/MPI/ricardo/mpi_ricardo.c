@@ -1,95 +1,82 @@
+// Comando para gerar o executável:
+// g++ -O3 -march=native -fopenmp-simd -c ../../../../common/stats_kernels.cpp
+// mpicc -O3 -march=native -I../../../../common mpi_ricardo.c -o mpi_ricardo stats_kernels.o -lm
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <mpi.h>
 #include <time.h>
 #include <math.h>
+#include <stdint.h>
+#include "running_stats.h"
+#include "node_reduce.h"   // redução hierárquica por nó (pasta common/)
+#include "philox.h"        // gerador baseado em contador (pasta common/)
+#include "stats_kernels.h" // kernels SIMD (AVX2/AVX-512) da pasta common/
 
 #define N 1000  // Tamanho da matriz
 
-// Função para inicializar a matriz com valores aleatórios
-void inicializar_matriz(int *matriz, int tamanho) {
-    srand(time(NULL));
-    for (int i = 0; i < tamanho * tamanho; i++) {
-        matriz[i] = (rand() % 20001) - 10000; // Gera valores entre -10000 e 10000
-    }
+// Função para inicializar as linhas [primeira_linha, primeira_linha + linhas)
+// da matriz com valores entre -10000 e 10000. Cada elemento depende só do
+// seu índice global e da semente (Philox), então cada processo gera o seu
+// próprio bloco e a matriz é a mesma para qualquer número de processos
+void inicializar_linhas(int *matriz, long long primeira_linha, int linhas, uint64_t semente) {
+    philox_fill_ints(matriz, (uint64_t)primeira_linha * N, (long long)linhas * N, semente, -10000, 10000);
 }
 
-// Função para calcular a média e o desvio padrão
-void calcular_estatisticas(int *matriz, int tamanho, double *media, double *desvio_padrao) {
-    double soma = 0.0;
-    double soma_quadrados = 0.0;
-
-    for (int i = 0; i < tamanho * tamanho; i++) {
-        soma += matriz[i];
-        soma_quadrados += matriz[i] * matriz[i];
-    }
-
-    *media = soma / (tamanho * tamanho);
-    *desvio_padrao = sqrt((soma_quadrados / (tamanho * tamanho)) - (*media) * (*media));
-}
-
-// Função para contar valores e determinar se a matriz é esparsa
-void analisar_matriz(int *matriz, int tamanho, int *contagem_negativos, int *menor_valor, int *maior_valor, int *contagem_zeros, int *eh_esparsa) {
-    *contagem_negativos = 0;
-    *contagem_zeros = 0;
-    *menor_valor = matriz[0];
-    *maior_valor = matriz[0];
-
-    for (int i = 0; i < tamanho * tamanho; i++) {
-        if (matriz[i] < 0) (*contagem_negativos)++;
-        if (matriz[i] == 0) (*contagem_zeros)++;
-        if (matriz[i] < *menor_valor) *menor_valor = matriz[i];
-        if (matriz[i] > *maior_valor) *maior_valor = matriz[i];
-    }
-
-    // Determina se a matriz é esparsa
-    *eh_esparsa = (*contagem_zeros > (tamanho * tamanho / 2)) ? 1 : 0;
+// Função para analisar um bloco da matriz: contagens, extremos, média e M2
+// (Welford/Chan) são calculados num único passe, sem somar quadrados em int
+void analisar_matriz(const int *matriz, long long num_elementos, RunningStats *estatisticas) {
+    running_stats_init(estatisticas);
+    stats_reduce_i32(estatisticas, matriz, num_elementos);
 }
 
 int main(int argc, char** argv) {
     int rank, tamanho_comunicador;
-    int *matriz = NULL;
-    int contagem_negativos_local, contagem_negativos_total;
-    int contagem_zeros_local, contagem_zeros_total;
-    int menor_valor_local, menor_valor_global;
-    int maior_valor_local, maior_valor_global;
-    double media, desvio_padrao;
-    int eh_esparsa;
+    RunningStats estatisticas_locais, estatisticas_globais;
+    NodeReducer redutor;
 
     MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &tamanho_comunicador);
 
-    int elementos_por_processo = (N * N) / tamanho_comunicador;
-    int *matriz_local = (int *)malloc(elementos_por_processo * sizeof(int));
-
+    // Semente opcional na linha de comando (para repetir uma execução);
+    // senão o rank 0 sorteia pelo relógio e envia para os demais
+    uint64_t semente = 0;
     if (rank == 0) {
-        matriz = (int *)malloc(N * N * sizeof(int));
-        inicializar_matriz(matriz, N);
+        semente = argc > 1 ? strtoull(argv[1], NULL, 10) : (uint64_t)time(NULL);
     }
+    MPI_Bcast(&semente, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
 
-    // Distribuição dos dados
-    MPI_Scatter(matriz, elementos_por_processo, MPI_INT, matriz_local, elementos_por_processo, MPI_INT, 0, MPI_COMM_WORLD);
+    // Divisão por linhas: os primeiros N % p processos ficam com uma a mais.
+    // Cada processo gera direto as suas linhas, sem MPI_Scatter
+    int linhas_locais = N / tamanho_comunicador + (rank < N % tamanho_comunicador ? 1 : 0);
+    long long primeira_linha = (long long)rank * (N / tamanho_comunicador) +
+                               (rank < N % tamanho_comunicador ? rank : N % tamanho_comunicador);
+    int *matriz_local = (int *)malloc((size_t)linhas_locais * N * sizeof(int));
+    inicializar_linhas(matriz_local, primeira_linha, linhas_locais, semente);
 
     // Cálculo local
-    analisar_matriz(matriz_local, N / tamanho_comunicador, &contagem_negativos_local, &menor_valor_local, &maior_valor_local, &contagem_zeros_local, &eh_esparsa);
+    analisar_matriz(matriz_local, (long long)linhas_locais * N, &estatisticas_locais);
 
-    // Redução dos valores
-    MPI_Reduce(&contagem_negativos_local, &contagem_negativos_total, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&contagem_zeros_local, &contagem_zeros_total, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&menor_valor_local, &menor_valor_global, 1, MPI_INT, MPI_MIN, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&maior_valor_local, &maior_valor_global, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+    // Redução dos valores: uma única operação combina todas as estatísticas,
+    // primeiro dentro de cada nó (memória compartilhada) e depois entre os
+    // líderes dos nós
+    node_reduce_init(&redutor, MPI_COMM_WORLD);
+    node_reduce(&redutor, &estatisticas_locais, &estatisticas_globais);
+    node_reduce_free(&redutor);
 
     if (rank == 0) {
-        calcular_estatisticas(matriz, N, &media, &desvio_padrao);
-        printf("Número de elementos negativos: %d\n", contagem_negativos_total);
-        printf("Maior valor: %d\n", maior_valor_global);
-        printf("Menor valor: %d\n", menor_valor_global);
+        double media = estatisticas_globais.mean;
+        double desvio_padrao = sqrt(running_stats_variance(&estatisticas_globais));
+        int eh_esparsa = estatisticas_globais.zeros > estatisticas_globais.count / 2;
+        printf("Semente: %llu\n", (unsigned long long)semente);
+        printf("Número de elementos negativos: %lld\n", estatisticas_globais.negatives);
+        printf("Maior valor: %.0f\n", estatisticas_globais.max);
+        printf("Menor valor: %.0f\n", estatisticas_globais.min);
         printf("Média: %.2f\n", media);
         printf("Desvio padrão: %.2f\n", desvio_padrao);
-        printf("Número de zeros: %d\n", contagem_zeros_total);
+        printf("Número de zeros: %lld\n", estatisticas_globais.zeros);
         printf("A matriz é %sesparsa\n", (eh_esparsa ? "" : "não "));
-        free(matriz);
     }
 
     free(matriz_local);
@@ -0,0 +1,153 @@
+// Allreduce em anel (common/ring_allreduce.h) x MPI_Allreduce, do tamanho
+// de latência ao de banda.
+//
+// Para cada tamanho de buffer (doubles, MPI_SUM) mede o MPI_Allreduce da
+// biblioteca e o anel com cada tamanho de segmento pedido (sempre o anel:
+// min_bytes = 0). Os valores são inteiros pequenos, então as somas são
+// exatas e o resultado do anel tem de bater bit a bit com o do
+// MPI_Allreduce.
+//
+// Banda de barramento (busbw) = 2 (p-1)/p * bytes / tempo: o que cada rank
+// de fato transmite num allreduce ótimo; comparável entre números de
+// processos e com a banda do link.
+//
+// Comando para gerar o executável: make
+// Comando para executar:
+//   mpirun -np 4 ./ring_bench                         (4 KiB a 64 MiB, segmentos de 16, 64 e 256 KiB)
+//   mpirun -np 8 ./ring_bench -b 256 -S 32,128,1024   (até 256 MiB)
+//   mpirun -np 4 ./ring_bench -a 0.001 -b 1 -r 50     (só tamanhos pequenos, 1 KiB a 1 MiB)
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ring_allreduce.h" // pasta common/ na raiz
+
+#define MAX_SEGMENT_SIZES 8
+#define TARGET_SECONDS 0.05 // repete cada medida até somar ~50 ms
+
+// Melhor tempo médio por chamada (no rank mais lento) de `reps` medidas
+static double measure(int use_ring, const RingAllreduceOptions *opt, const double *send, double *recv, long long n,
+                      int reps) {
+    // Calibra: quantas chamadas por medida para passar de TARGET_SECONDS / reps
+    int iters = 1;
+    for (;;) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        for (int i = 0; i < iters; i++) {
+            if (use_ring) ring_allreduce(send, recv, n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, opt);
+            else MPI_Allreduce(send, recv, (int)n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        }
+        double elapsed = MPI_Wtime() - start;
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        if (elapsed * reps >= TARGET_SECONDS || iters >= (1 << 20)) break;
+        iters *= 2;
+    }
+
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        for (int i = 0; i < iters; i++) {
+            if (use_ring) ring_allreduce(send, recv, n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, opt);
+            else MPI_Allreduce(send, recv, (int)n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        }
+        double elapsed = (MPI_Wtime() - start) / iters;
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int rank, size;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    double min_mb = 4.0 / 1024, max_mb = 64;
+    const char *segments_arg = "16,64,256";
+    int reps = 5, opt;
+    while ((opt = getopt(argc, argv, "a:b:S:r:")) != -1) {
+        switch (opt) {
+        case 'a': min_mb = atof(optarg); break;
+        case 'b': max_mb = atof(optarg); break;
+        case 'S': segments_arg = optarg; break;
+        case 'r': reps = atoi(optarg); break;
+        default:
+            if (rank == 0)
+                fprintf(stderr, "Usage: %s [-a min_MiB] [-b max_MiB] [-S segment_KiB,...] [-r reps]\n", argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    long long segments[MAX_SEGMENT_SIZES];
+    int nsegments = 0;
+    for (const char *c = segments_arg; *c != '\0' && nsegments < MAX_SEGMENT_SIZES;) {
+        char *end;
+        long long kib = strtoll(c, &end, 10);
+        if (end == c || kib <= 0) {
+            nsegments = 0;
+            break;
+        }
+        segments[nsegments++] = kib << 10;
+        c = *end == ',' ? end + 1 : end;
+    }
+    long long min_bytes = (long long)(min_mb * (1 << 20)), max_bytes = (long long)(max_mb * (1 << 20));
+    if (nsegments == 0 || min_bytes < (long long)sizeof(double) || max_bytes < min_bytes || reps <= 0 ||
+        max_bytes / (long long)sizeof(double) > 0x7FFFFFFF) {
+        if (rank == 0) fprintf(stderr, "Invalid sizes, segment list or repetition count\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    long long max_n = max_bytes / sizeof(double);
+    double *send = malloc(max_n * sizeof(double));
+    double *expected = malloc(max_n * sizeof(double));
+    double *result = malloc(max_n * sizeof(double));
+    if (send == NULL || expected == NULL || result == NULL) {
+        fprintf(stderr, "Rank %d: Error allocating buffers\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (long long i = 0; i < max_n; i++) send[i] = (double)((rank * 7 + i) % 13);
+
+    if (rank == 0) {
+        printf("Allreduce de doubles (MPI_SUM), %d processos, melhor de %d\n", size, reps);
+        printf("%12s %11s %9s", "bytes", "MPI (us)", "busbw");
+        for (int s = 0; s < nsegments; s++) {
+            char head[32];
+            snprintf(head, sizeof head, "anel %lldK", segments[s] >> 10);
+            printf(" %11s %9s", head, "busbw");
+        }
+        printf("\n%12s %11s %9s", "", "", "GB/s");
+        for (int s = 0; s < nsegments; s++) printf(" %11s %9s", "(us)", "GB/s");
+        printf("\n");
+    }
+
+    int failed = 0;
+    double factor = size > 1 ? 2.0 * (size - 1) / size : 1.0;
+    for (long long bytes = min_bytes; bytes <= max_bytes; bytes *= 4) {
+        long long n = bytes / sizeof(double);
+        double t_mpi = measure(0, NULL, send, expected, n, reps);
+        if (rank == 0) printf("%12lld %11.1f %9.2f", n * (long long)sizeof(double), t_mpi * 1e6, factor * bytes / t_mpi / 1e9);
+        for (int s = 0; s < nsegments; s++) {
+            RingAllreduceOptions ring;
+            ring.segment_bytes = segments[s];
+            ring.min_bytes = 0; // sempre o anel, inclusive nos tamanhos de latência
+            double t = measure(1, &ring, send, result, n, reps);
+            int bad = memcmp(result, expected, n * sizeof(double)) != 0;
+            MPI_Allreduce(MPI_IN_PLACE, &bad, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+            failed |= bad;
+            if (rank == 0) printf(" %11.1f %9.2f%s", t * 1e6, factor * bytes / t / 1e9, bad ? " ERRO" : "");
+        }
+        if (rank == 0) printf("\n");
+    }
+
+    free(send);
+    free(expected);
+    free(result);
+    MPI_Finalize();
+    return failed;
+}
@@ -0,0 +1,248 @@
+// Benchmark de largura de banda de memória no estilo STREAM (McCalpin):
+// copy, scale, add e triad, com MPI + OpenMP.
+//
+// O kernel add (c[i] = a[i] + b[i]) é o laço do work2/vectorsum/vectorsum.c;
+// os outros três completam o STREAM. Todos os analisadores do repositório são
+// limitados pela memória: o triad em tamanho de DRAM é o teto (roofline) de
+// GB/s que eles podem alcançar na máquina.
+//
+// Comando para gerar o executável: make
+// Comando para executar:
+//   mpirun -np 4 ./stream_bench                      (varredura de 4 KiB a 64 MiB por vetor)
+//   mpirun -np 2 ./stream_bench -t 4 -m 512 -r 10    (até 512 MiB por vetor, 4 threads por processo)
+//   OMP_PROC_BIND=spread OMP_PLACES=cores mpirun -np 2 --bind-to socket ./stream_bench
+//
+// Detalhes:
+//  - vetores alinhados a 64 bytes (linha de cache);
+//  - primeiro toque: os vetores são alocados de novo a cada tamanho e cada
+//    thread inicializa as páginas que vai usar, com a mesma divisão dos
+//    kernels para aquele n, então em NUMA elas ficam no nó da thread;
+//  - com AVX/AVX-512, cada tamanho roda também com stores não temporais
+//    (streaming stores, que não trazem a linha para o cache antes de
+//    escrever): ganham em tamanho de DRAM e perdem quando os vetores cabem
+//    no cache;
+//  - tamanhos pequenos repetem o kernel até cada medida durar alguns
+//    milissegundos; vale o melhor de -r medidas no rank mais lento;
+//  - GB/s agregado = bytes de todos os ranks / tempo; por rank e por nó
+//    (ranks com memória compartilhada, MPI_Comm_split_type) são divisões
+//    desse total.
+
+#include <mpi.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#define MIN_BYTES (4 << 10)        // menor vetor: 4 KiB (três cabem no L1)
+#define DEFAULT_MAX_MB 64          // maior vetor padrão por processo, em MiB
+#define TARGET_BYTES (64 << 20)    // bytes movidos por medida (repete o kernel)
+#define SCALAR 3.0
+#define ALIGN 64                   // bytes; também o passo de divisão entre threads
+
+enum { COPY, SCALE, ADD, TRIAD, KERNELS };
+static const char *kernel_names[KERNELS] = {"copy", "scale", "add", "triad"};
+static const int kernel_arrays[KERNELS] = {2, 2, 3, 3}; // vetores lidos + escritos
+
+// Stores não temporais: um vetor SIMD por vez, alinhado
+#if defined(__AVX512F__)
+#define NT_AVAILABLE 1
+#define NT_WIDTH 8
+typedef __m512d vec_t;
+#define vec_load _mm512_load_pd
+#define vec_stream _mm512_stream_pd
+#define vec_set1 _mm512_set1_pd
+#define vec_add _mm512_add_pd
+#define vec_mul _mm512_mul_pd
+#elif defined(__AVX__)
+#define NT_AVAILABLE 1
+#define NT_WIDTH 4
+typedef __m256d vec_t;
+#define vec_load _mm256_load_pd
+#define vec_stream _mm256_stream_pd
+#define vec_set1 _mm256_set1_pd
+#define vec_add _mm256_add_pd
+#define vec_mul _mm256_mul_pd
+#else
+#define NT_AVAILABLE 0
+#endif
+
+// Um kernel sobre [lo, hi) (lo e hi múltiplos de ALIGN / sizeof(double))
+static void kernel_range(int kernel, double *a, double *b, double *c, long lo, long hi, int nt) {
+#if NT_AVAILABLE
+    if (nt) {
+        vec_t s = vec_set1(SCALAR);
+        for (long i = lo; i < hi; i += NT_WIDTH) {
+            switch (kernel) {
+            case COPY:  vec_stream(&c[i], vec_load(&a[i])); break;
+            case SCALE: vec_stream(&b[i], vec_mul(s, vec_load(&c[i]))); break;
+            case ADD:   vec_stream(&c[i], vec_add(vec_load(&a[i]), vec_load(&b[i]))); break;
+            case TRIAD: vec_stream(&a[i], vec_add(vec_load(&b[i]), vec_mul(s, vec_load(&c[i])))); break;
+            }
+        }
+        _mm_sfence(); // os stores não temporais ficam visíveis antes da barreira
+        return;
+    }
+#else
+    (void)nt;
+#endif
+    switch (kernel) {
+    case COPY:  for (long i = lo; i < hi; i++) c[i] = a[i]; break;
+    case SCALE: for (long i = lo; i < hi; i++) b[i] = SCALAR * c[i]; break;
+    case ADD:   for (long i = lo; i < hi; i++) c[i] = a[i] + b[i]; break; // o laço do vectorsum.c
+    case TRIAD: for (long i = lo; i < hi; i++) a[i] = b[i] + SCALAR * c[i]; break;
+    }
+}
+
+// Faixa da thread t de nt em n elementos, alinhada a ALIGN bytes. A mesma
+// divisão é usada no primeiro toque e nos kernels
+static void thread_range(long n, int t, int nt, long *lo, long *hi) {
+    long step = ALIGN / sizeof(double), chunks = n / step;
+    *lo = chunks * t / nt * step;
+    *hi = chunks * (t + 1) / nt * step;
+}
+
+// Melhor tempo (no rank mais lento) de `reps` medidas de `iters` execuções
+static double measure(int kernel, double *a, double *b, double *c, long n, long iters, int reps, int nt) {
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        // Uma região paralela por medida: as repetições ficam dentro dela,
+        // separadas só por barreiras, para não medir fork/join nos tamanhos
+        // pequenos
+        #pragma omp parallel
+        {
+            long lo, hi;
+            thread_range(n, omp_get_thread_num(), omp_get_num_threads(), &lo, &hi);
+            for (long it = 0; it < iters; it++) {
+                kernel_range(kernel, a, b, c, lo, hi, nt);
+                #pragma omp barrier
+            }
+        }
+        double elapsed = MPI_Wtime() - start;
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int provided, rank, size;
+    // Só a thread principal chama MPI; as regiões OpenMP ficam entre chamadas
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    long max_mb = DEFAULT_MAX_MB;
+    int reps = 5, opt;
+    while ((opt = getopt(argc, argv, "m:r:t:")) != -1) {
+        switch (opt) {
+        case 'm': max_mb = atol(optarg); break;
+        case 'r': reps = atoi(optarg); break;
+        case 't': omp_set_num_threads(atoi(optarg)); break;
+        default:
+            if (rank == 0) fprintf(stderr, "Usage: %s [-m max_MiB_per_vector] [-r reps] [-t threads]\n", argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    if (max_mb <= 0 || reps <= 0) {
+        if (rank == 0) fprintf(stderr, "Invalid size or repetition count\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Nós: ranks que compartilham memória; o rank 0 de cada um conta
+    MPI_Comm node;
+    int node_rank, nodes;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+    MPI_Comm_rank(node, &node_rank);
+    nodes = node_rank == 0;
+    MPI_Allreduce(MPI_IN_PLACE, &nodes, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Comm_free(&node);
+
+    size_t max_bytes = (size_t)max_mb << 20;
+
+    if (rank == 0) {
+        printf("STREAM: %d processos em %d nó(s), %d threads por processo, melhor de %d\n", size, nodes,
+               omp_get_max_threads(), reps);
+        printf("Stores não temporais: %s\n", NT_AVAILABLE ? "sim" : "não disponíveis (sem AVX)");
+        printf("%12s %-7s %10s %10s %10s %10s %12s %12s\n", "vetor/rank", "stores", kernel_names[COPY],
+               kernel_names[SCALE], kernel_names[ADD], kernel_names[TRIAD], "triad/rank", "triad/nó");
+        printf("%12s %-7s %10s %10s %10s %10s %12s %12s\n", "", "", "GB/s", "GB/s", "GB/s", "GB/s", "GB/s", "GB/s");
+    }
+
+    int failed = 0;
+    for (size_t bytes = MIN_BYTES; bytes <= max_bytes; bytes *= 2) {
+        long n = (long)(bytes / sizeof(double));
+        long iters = TARGET_BYTES / (long)bytes > 1 ? TARGET_BYTES / (long)bytes : 1;
+
+        // Vetores novos a cada tamanho, com primeiro toque pela divisão dos
+        // kernels para este n: a faixa de cada thread fica no seu nó NUMA em
+        // todos os tamanhos que passam do cache, não só no maior. Acima do
+        // limiar de mmap do malloc (no máximo 32 MiB), as páginas são novas;
+        // e como os tamanhos só crescem, o limiar dinâmico nunca chega a
+        // reaproveitar as páginas do tamanho anterior
+        double *a = (double *)aligned_alloc(ALIGN, bytes);
+        double *b = (double *)aligned_alloc(ALIGN, bytes);
+        double *c = (double *)aligned_alloc(ALIGN, bytes);
+        if (a == NULL || b == NULL || c == NULL) {
+            fprintf(stderr, "Rank %d: Error allocating 3 x %zu bytes\n", rank, bytes);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        #pragma omp parallel
+        {
+            long lo, hi;
+            thread_range(n, omp_get_thread_num(), omp_get_num_threads(), &lo, &hi);
+            for (long i = lo; i < hi; i++) {
+                a[i] = 1.0;
+                b[i] = 2.0;
+                c[i] = 0.0;
+            }
+        }
+
+        for (int nt = 0; nt <= NT_AVAILABLE; nt++) {
+            double gbs[KERNELS];
+            for (int k = 0; k < KERNELS; k++) {
+                double t = measure(k, a, b, c, n, iters, reps, nt);
+                gbs[k] = (double)size * kernel_arrays[k] * bytes * iters / t / 1e9;
+            }
+
+            // Conferência como no STREAM: partindo de a = 1, b = 2, c = 0, a
+            // sequência copy, scale, add, triad (cada um idempotente) termina
+            // com c = 1 + 3 = 4, b = 3 e a = 3 + 3 * 4 = 15
+            long bad = 0;
+            for (long i = 0; i < n; i++) bad += a[i] != 15.0 || b[i] != 3.0 || c[i] != 4.0;
+            MPI_Allreduce(MPI_IN_PLACE, &bad, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+            failed |= bad != 0;
+            #pragma omp parallel
+            {
+                long lo, hi;
+                thread_range(n, omp_get_thread_num(), omp_get_num_threads(), &lo, &hi);
+                for (long i = lo; i < hi; i++) {
+                    a[i] = 1.0;
+                    b[i] = 2.0;
+                    c[i] = 0.0;
+                }
+            }
+
+            if (rank == 0) {
+                char label[32];
+                if (bytes < (1 << 20)) snprintf(label, sizeof label, "%zu KiB", bytes >> 10);
+                else snprintf(label, sizeof label, "%zu MiB", bytes >> 20);
+                printf("%12s %-7s %10.2f %10.2f %10.2f %10.2f %12.2f %12.2f%s\n", label, nt ? "nt" : "normal",
+                       gbs[COPY], gbs[SCALE], gbs[ADD], gbs[TRIAD], gbs[TRIAD] / size, gbs[TRIAD] / nodes,
+                       bad ? "  ERRO na conferência" : "");
+            }
+        }
+        free(a);
+        free(b);
+        free(c);
+    }
+
+    MPI_Finalize();
+    return failed;
+}
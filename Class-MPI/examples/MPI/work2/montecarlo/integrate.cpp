@@ -0,0 +1,143 @@
+// Integrais de Monte Carlo com o integrador genérico de common/montecarlo.hpp
+// (a generalização do montec.c: o integrando é um functor de D dimensões).
+//
+// Comando para executar no terminal
+// mpicxx -O3 -march=native -fopenmp -I../../../../../common integrate.cpp -o integrate
+// mpirun -np 4 --host localhost --oversubscribe ./integrate                    (todas as integrais, 10^7 pontos)
+// mpirun -np 4 --host localhost --oversubscribe ./integrate -i gauss4 -n 1e9 -t 2
+// mpirun -np 4 --host localhost --oversubscribe ./integrate -m sobol -r 32      (quase aleatório, 32 réplicas)
+// mpirun -np 4 --host localhost --oversubscribe ./integrate -m estratificado -k 1   (Monte Carlo simples)
+
+#include <mpi.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "montecarlo.hpp"
+
+// pi pela área do quarto de círculo (o integrando do montec.c)
+struct QuarterCircle {
+    double operator()(const double *x) const { return 4.0 * (x[0] * x[0] + x[1] * x[1] <= 1.0); }
+};
+
+// Volume da bola unitária em 8 dimensões: pi^4 / 24
+struct Ball8 {
+    double operator()(const double *x) const {
+        double r2 = 0.0;
+        for (int d = 0; d < 8; d++) r2 += x[d] * x[d];
+        return r2 <= 1.0;
+    }
+};
+
+// Gaussiana em 4 dimensões sobre [-2, 2]^4: (sqrt(pi) erf(2))^4
+struct Gauss4 {
+    double operator()(const double *x) const {
+        return std::exp(-(x[0] * x[0] + x[1] * x[1] + x[2] * x[2] + x[3] * x[3]));
+    }
+};
+
+// Produto de cossenos em 6 dimensões sobre [0, pi/2]^6: 1
+struct Cos6 {
+    double operator()(const double *x) const {
+        double p = 1.0;
+        for (int d = 0; d < 6; d++) p *= std::cos(x[d]);
+        return p;
+    }
+};
+
+struct Config {
+    const char *integral = NULL; // NULL = todas
+    const char *method = "estratificado";
+    int per_dim = 0;
+    int replicates = 16;
+    mc::Options options;
+};
+
+// Devolve 0, ou 1 se a configuração não serve para esta integral
+template <int D, class F>
+int run(const char *name, const F &f, const mc::Domain<D> &domain, double exact, const Config &cfg, int rank) {
+    if (cfg.integral != NULL && std::strcmp(cfg.integral, name) != 0) return 0;
+    if (std::strcmp(cfg.method, "sobol") != 0 && cfg.per_dim > 0 &&
+        !mc::Stratified::fits<D>(cfg.per_dim, cfg.options.samples)) {
+        if (rank == 0)
+            std::fprintf(stderr, "%s: -k %d gives %.3g cells in %d dimensions (limit: %lld and points / 2)\n", name,
+                         cfg.per_dim, std::pow(static_cast<double>(cfg.per_dim), D), D, mc::MAX_CELLS);
+        return 1;
+    }
+    MPI_Barrier(cfg.options.comm);
+    double start = MPI_Wtime();
+    mc::Result r;
+    if (std::strcmp(cfg.method, "sobol") == 0) {
+        mc::Sobol sobol;
+        sobol.replicates = cfg.replicates;
+        r = mc::integrate(f, domain, sobol, cfg.options);
+    } else {
+        mc::Stratified stratified;
+        stratified.per_dim = cfg.per_dim;
+        r = mc::integrate(f, domain, stratified, cfg.options);
+    }
+    double elapsed = MPI_Wtime() - start;
+    if (rank == 0)
+        std::printf("%-8s %2d %16.10f %14.3e %14.3e %8.2f %12llu %6lld %9.3f %10.1f\n", name, D, r.value,
+                    1.96 * r.std_error, r.value - exact, std::fabs(r.value - exact) / r.std_error,
+                    (unsigned long long)r.samples, r.cells, elapsed, r.samples / elapsed / 1e6);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int provided, rank, size;
+    // Só a thread principal chama MPI; as regiões OpenMP ficam entre chamadas
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    Config cfg;
+    cfg.options.samples = 10000000;
+    cfg.options.comm = MPI_COMM_WORLD;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:m:n:k:r:s:t:")) != -1) {
+        switch (opt) {
+        case 'i': cfg.integral = optarg; break;
+        case 'm': cfg.method = optarg; break;
+        case 'n': cfg.options.samples = (std::uint64_t)std::strtod(optarg, NULL); break;
+        case 'k': cfg.per_dim = std::atoi(optarg); break;
+        case 'r': cfg.replicates = std::atoi(optarg); break;
+        case 's': cfg.options.seed = std::strtoull(optarg, NULL, 10); break;
+        case 't': cfg.options.threads = std::atoi(optarg); break;
+        default:
+            if (rank == 0)
+                std::fprintf(stderr, "Usage: %s [-i pi|ball8|gauss4|cos6] [-m estratificado|sobol] [-n points] "
+                                     "[-k strata_per_dim] [-r replicates] [-s seed] [-t threads]\n", argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    if (cfg.options.samples == 0 || cfg.replicates < 2 ||
+        (std::strcmp(cfg.method, "sobol") != 0 && std::strcmp(cfg.method, "estratificado") != 0)) {
+        if (rank == 0) std::fprintf(stderr, "Invalid point count, replicate count or method\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (rank == 0) {
+        std::printf("Método: %s, %d processos, semente %llu\n", cfg.method, size,
+                    (unsigned long long)cfg.options.seed);
+        std::printf("%-8s %2s %16s %14s %14s %8s %12s %6s %9s %10s\n", "integral", "D", "estimativa",
+                    "IC 95% (±)", "erro", "erro/σ", "pontos", "células", "tempo (s)", "Mpontos/s");
+    }
+
+    const double pi = std::acos(-1.0);
+    int failed = 0;
+    failed |= run("pi", QuarterCircle(), mc::Domain<2>{{0, 0}, {1, 1}}, pi, cfg, rank);
+    failed |= run("ball8", Ball8(), mc::Domain<8>{{-1, -1, -1, -1, -1, -1, -1, -1}, {1, 1, 1, 1, 1, 1, 1, 1}},
+        std::pow(pi, 4) / 24.0, cfg, rank);
+    failed |= run("gauss4", Gauss4(), mc::Domain<4>{{-2, -2, -2, -2}, {2, 2, 2, 2}},
+        std::pow(std::sqrt(pi) * std::erf(2.0), 4), cfg, rank);
+    failed |= run("cos6", Cos6(), mc::Domain<6>{{0, 0, 0, 0, 0, 0}, {pi / 2, pi / 2, pi / 2, pi / 2, pi / 2, pi / 2}},
+        1.0, cfg, rank);
+
+    MPI_Finalize();
+    return failed;
+}
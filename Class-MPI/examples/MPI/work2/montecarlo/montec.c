@@ -1,87 +1,224 @@
 // Comando para executar no terminal
-// mpicc montec.c -o montec
-// mpirun -np 4 --host localhost --oversubscribe ./montec
-// Saída esperada: Aproximação de Pi: 3.144204
+// mpicc -O3 -march=native -fopenmp -I../../../../../common montec.c -o montec -lm
+// mpirun -np 4 --host localhost --oversubscribe ./montec                 (10^6 pontos)
+// mpirun -np 4 --host localhost --oversubscribe ./montec -n 1e10 -t 2    (10^10 pontos, 2 threads por processo)
+// mpirun -np 4 --host localhost --oversubscribe ./montec -n 1e9 -s 42    (semente fixa: mesmo resultado com qualquer -np/-t)
+// mpirun -np 4 --host localhost --oversubscribe ./montec -e 1e-5         (adaptativo: para quando o IC 95% for ± 1e-5)
+// Saída esperada (semente 42, 10^6 pontos): Aproximação de Pi: 3.14... ± 0.0032 (IC 95%)
 
 #include <mpi.h>
+#include <omp.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include "philox.h" // gerador baseado em contador (pasta common/ na raiz)
 
-#define NUM_POINTS 1000000
+#define DEFAULT_POINTS 1000000
+#define BATCH_POINTS (2 * PHILOX_BATCH) // cada bloco Philox (4 palavras) dá 2 pontos
+#define DEFAULT_ROUND_POINTS 1000000     // modo adaptativo: pontos por processo por rodada
+#define DEFAULT_MAX_POINTS 1e12          // modo adaptativo: limite quando -n não é dado
+#define PROGRESS_POINTS (1 << 20)        // pontos entre chamadas de MPI_Test
+
+// O ponto de índice global i usa as palavras (0, 1) ou (2, 3) do bloco
+// Philox de contador i / 2. Como cada ponto depende só do seu índice e da
+// semente, cada processo e cada thread percorre a sua faixa de índices, que
+// é uma sequência independente das outras, sem estado compartilhado e sem
+// sementes do tipo time(NULL) + rank (que se repetem entre execuções e se
+// sobrepõem entre processos). O total de acertos é o mesmo para qualquer
+// número de processos e threads.
+
+// Pontos [first, last) um a um (início e fim fora do alinhamento do lote)
+static uint64_t count_points(uint64_t seed, uint64_t first, uint64_t last) {
+    uint64_t hits = 0;
+    uint32_t r[4];
+    for (uint64_t i = first; i < last; i++) {
+        philox_block(seed, 0, i / 2, r);
+        double x = philox_to_unit(r[2 * (i % 2)]);
+        double y = philox_to_unit(r[2 * (i % 2) + 1]);
+        hits += x * x + y * y <= 1.0;
+    }
+    return hits;
+}
+
+// Um lote de BATCH_POINTS pontos a partir do bloco `first_block`: geração e
+// teste do círculo vetorizados, sem desvios
+static inline uint64_t count_batch(uint64_t seed, uint64_t first_block) {
+    uint32_t r[4][PHILOX_BATCH];
+    philox_batch(seed, 0, first_block, r);
+    uint32_t hits = 0;
+    #pragma omp simd reduction(+ : hits)
+    for (int j = 0; j < PHILOX_BATCH; j++) {
+        double x0 = philox_to_unit(r[0][j]), y0 = philox_to_unit(r[1][j]);
+        double x1 = philox_to_unit(r[2][j]), y1 = philox_to_unit(r[3][j]);
+        hits += (x0 * x0 + y0 * y0 <= 1.0) + (x1 * x1 + y1 * y1 <= 1.0);
+    }
+    return hits;
+}
+
+// Acertos entre os pontos [first, last): as pontas fora do alinhamento vão
+// uma a uma e os lotes do meio são divididos entre as threads. Os
+// acumuladores são de 64 bits (um int estoura acima de 2^31 acertos)
+static uint64_t count_range(uint64_t seed, uint64_t first, uint64_t last) {
+    uint64_t body_first = (first + BATCH_POINTS - 1) / BATCH_POINTS * BATCH_POINTS;
+    uint64_t body_last = last / BATCH_POINTS * BATCH_POINTS;
+    if (body_first > last) body_first = last;
+    if (body_last < body_first) body_last = body_first;
+
+    uint64_t hits = count_points(seed, first, body_first) + count_points(seed, body_last, last);
+    long long batches = (long long)((body_last - body_first) / BATCH_POINTS);
+    #pragma omp parallel for schedule(static) reduction(+ : hits)
+    for (long long b = 0; b < batches; b++)
+        hits += count_batch(seed, (body_first + (uint64_t)b * BATCH_POINTS) / 2);
+    return hits;
+}
+
+// Meia largura do intervalo de 95% da estimativa de pi com `hits` acertos
+// em `points` pontos: cada ponto é uma Bernoulli com p = pi/4, então pi ≈ 4p
+// com erro padrão 4 * sqrt(p(1 - p)/n)
+static double half_width(uint64_t points, uint64_t hits) {
+    double p = (double)hits / (double)points;
+    return 1.96 * 4.0 * sqrt(p * (1.0 - p) / (double)points);
+}
+
+/**
+ * Modo adaptativo: amostra em rodadas de `round_points` pontos por processo
+ * até a meia largura do IC 95% cair abaixo de `tolerance` (ou o total
+ * passar de `max_points`, arredondado para rodadas inteiras). Na rodada r,
+ * o processo k usa os pontos [(r * num_tasks + k) * round_points, ... +
+ * round_points), então as faixas continuam disjuntas.
+ *
+ * Ao fim de cada rodada, os totais acumulados (pontos, acertos) vão num
+ * MPI_Iallreduce e a rodada seguinte é amostrada enquanto ele anda (com
+ * MPI_Test entre os pedaços, para a comunicação progredir). O resultado só
+ * é lido no fim dessa rodada seguinte: a sincronização global nunca para a
+ * amostragem e, como todos leem os mesmos totais na mesma rodada, todos
+ * param juntos. Os pontos da última rodada, amostrada durante a decisão,
+ * também entram no resultado final.
+ */
+static void run_adaptive(uint64_t seed, int rank, int num_tasks, uint64_t round_points, uint64_t max_points,
+                         double tolerance, uint64_t local[2], uint64_t *rounds) {
+    uint64_t per_round = (uint64_t)num_tasks * round_points;
+    uint64_t max_rounds = (max_points + per_round - 1) / per_round;
+    uint64_t sent[2], snapshot[2];
+    MPI_Request request;
+    int pending = 0, done = 0;
+    local[0] = local[1] = 0;
+    *rounds = 0;
+    while (!done) {
+        uint64_t first = (*rounds * num_tasks + rank) * round_points;
+        for (uint64_t p = 0; p < round_points; p += PROGRESS_POINTS) {
+            uint64_t last = round_points - p < PROGRESS_POINTS ? round_points : p + PROGRESS_POINTS;
+            local[1] += count_range(seed, first + p, first + last);
+            if (pending) {
+                int flag;
+                MPI_Test(&request, &flag, MPI_STATUS_IGNORE);
+            }
+        }
+        local[0] += round_points;
+        (*rounds)++;
+
+        // Decide pelos totais da rodada anterior (o pedido pode já ter
+        // terminado num MPI_Test; MPI_Wait então retorna na hora)
+        if (pending) {
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+            pending = 0;
+            done = half_width(snapshot[0], snapshot[1]) <= tolerance;
+        }
+        if (*rounds >= max_rounds) done = 1;
+        if (!done) {
+            sent[0] = local[0];
+            sent[1] = local[1];
+            MPI_Iallreduce(sent, snapshot, 2, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD, &request);
+            pending = 1;
+        }
+    }
+}
 
 int main(int argc, char** argv) {
-    
-    int rank, num_tasks;
-    int points_in_circle = 0;
-    int total_points_in_circle;
-    double x, y;
-    // o seed foi definido como unsigned, pois a função rand_r
-    //  aceita um ponteiro para uma semente do tipo "unsigned int"
-    unsigned int seed;
+    int rank, num_tasks, provided;
 
     // Inicialize o ambiente MPI.
     // Cada processo deve obter seu rank e o número total de processos (tasks).
-    MPI_Init(&argc, &argv);
+    // Só a thread principal chama MPI; as threads OpenMP ficam entre as chamadas
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &num_tasks);
 
-
-    // Geração de Pontos Aleatórios
-    seed = time(NULL) + rank; // Semente única para cada processo
-    	// time(null) fornece a hora atual 
-    	// para solucionar o caso de processos iniciarem no mesmo segundo,
-    	// optou-se em colocar o rank para diferencia-los.
-    	// dessa forma, cada processo terá uma seed diferente
-
-    // Cada processo gera pontos e conta quantos estão dentro do círculo
-    for (int i = 0; i < NUM_POINTS / num_tasks; i++) {
-    	// uso do rand_r é porque ele é thread-safe
-    	// sem causar condição de corrida
-    	// link da explicação: https://www.ibm.com/docs/pt-br/i/7.5?topic=functions-rand-rand-r-generate-random-number
-    	
-        x = (double)rand_r(&seed) / RAND_MAX;
-        y = (double)rand_r(&seed) / RAND_MAX;
-        
-        // Contagem dos Pontos Dentro do Círculo
-        if (x * x + y * y <= 1.0) {
-            points_in_circle++;
+    // -n aceita notação científica (1e12): o total de pontos é de 64 bits
+    uint64_t num_points = DEFAULT_POINTS;
+    uint64_t seed = (uint64_t)time(NULL);
+    int threads = 0;
+    double tolerance = 0.0; // > 0: modo adaptativo
+    uint64_t round_points = DEFAULT_ROUND_POINTS;
+    int points_given = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:t:e:b:")) != -1) {
+        switch (opt) {
+        case 'n': num_points = (uint64_t)strtod(optarg, NULL); points_given = 1; break;
+        case 'e': tolerance = atof(optarg); break;
+        case 'b': round_points = (uint64_t)strtod(optarg, NULL); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 't': threads = atoi(optarg); break;
+        default:
+            if (rank == 0) fprintf(stderr, "Usage: %s [-n points] [-s seed] [-t threads] [-e tolerance [-b points_per_round]]\n", argv[0]);
+            MPI_Finalize();
+            return 1;
         }
     }
+    // No modo adaptativo, -n é o limite de pontos
+    if (tolerance > 0.0 && !points_given) num_points = (uint64_t)DEFAULT_MAX_POINTS;
+    if (num_points == 0 || threads < 0 || tolerance < 0.0 || round_points == 0) {
+        if (rank == 0) fprintf(stderr, "Invalid point or thread count\n");
+        MPI_Finalize();
+        return 1;
+    }
+    if (threads > 0) omp_set_num_threads(threads);
+
+    // Todos usam a semente do rank 0 (o relógio pode diferir entre nós)
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    // Totais deste processo: pontos e acertos
+    uint64_t local[2];
+    uint64_t rounds = 0;
+    double start = MPI_Wtime();
+    if (tolerance > 0.0) {
+        run_adaptive(seed, rank, num_tasks, round_points, num_points, tolerance, local, &rounds);
+    } else {
+        // Divisão desigual: os primeiros num_points % num_tasks processos
+        // ficam com um ponto a mais, então nenhum ponto é descartado
+        uint64_t base = num_points / num_tasks, extra = num_points % num_tasks;
+        uint64_t first = rank * base + ((uint64_t)rank < extra ? (uint64_t)rank : extra);
+        local[0] = base + ((uint64_t)rank < extra ? 1 : 0);
+        local[1] = count_range(seed, first, first + local[0]);
+    }
+
+    // Redução para somar os pontos e os pontos dentro do círculo de todos os processos
+    // sbuf = local -- ponteiro para os dados a serem enviados
+    // rbuf = total -- onde o resultado será armazenado (rank 0)
+    // count = 2, tipo MPI_UINT64_T, op = MPI_SUM, root = 0
+    uint64_t total[2] = {0, 0};
+    MPI_Reduce(local, total, 2, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    double elapsed = MPI_Wtime() - start;
 
-    // Redução para somar todos os pontos dentro do círculo de todos os processos
-    // exemplo: int MPI_Reduce(
-    
-    //const void* sbuf, 
-    //void* rbuf, 
-    //int count,
-    //MPI_Datatype stype, 
-    //MPI_Op op, 
-    //int root,
-    //MPI_Comm comm)
-    
-    // operação
-    MPI_Reduce(
-    &points_in_circle, 
-    &total_points_in_circle, 
-    1, 
-    MPI_INT, 
-    MPI_SUM, 
-    0, 
-    MPI_COMM_WORLD);
-    // sbuf =  &points_in_circle --ponteiros para dados a serem enviado
-    // rbuf = total_points_in_circle -- ponteiro p/ onde o resultado será armazenado
-    // count = 1 -- número de elementos no buffer de envio
-    // Mpi_datatype = Mpi_init
-    // op = mpi_sum -- tipo de operação de redução
-    // root = 0 -- rank do processo que será o recebidor
-    // comm = MPI_COMM_WORLD comunicador que define o grupo de processos
-
-    // execução do cálculo	
+    // execução do cálculo
     if (rank == 0) {
-        double pi = 4.0 * total_points_in_circle / NUM_POINTS;
+        double pi = 4.0 * (double)total[1] / (double)total[0];
+        double std_error = half_width(total[0], total[1]) / 1.96;
         // Exibição do Resultado
-        printf("Aproximação de Pi: %f\n", pi);
+        printf("Aproximação de Pi: %.10f ± %.10f (IC 95%%)\n", pi, 1.96 * std_error);
+        printf("Erro em relação a M_PI: %.3e (%.2f erros padrão)\n", pi - M_PI, fabs(pi - M_PI) / std_error);
+        printf("Pontos: %llu, dentro do círculo: %llu\n", (unsigned long long)total[0],
+               (unsigned long long)total[1]);
+        if (tolerance > 0.0)
+            printf("Modo adaptativo: tolerância %.1e, %llu rodadas de %llu pontos por processo%s\n", tolerance,
+                   (unsigned long long)rounds, (unsigned long long)round_points,
+                   half_width(total[0], total[1]) <= tolerance ? "" : " (limite de pontos atingido)");
+        printf("Semente: %llu\n", (unsigned long long)seed);
+        printf("Processos: %d, threads por processo: %d\n", num_tasks, omp_get_max_threads());
+        printf("Tempo: %.3f s (%.1f milhões de pontos/s)\n", elapsed, total[0] / elapsed / 1e6);
     }
 
     MPI_Finalize();
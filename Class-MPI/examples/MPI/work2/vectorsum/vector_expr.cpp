@@ -0,0 +1,142 @@
+// Soma de vetores (e outras operações elemento a elemento) com o vetor
+// distribuído de common/dist_vector.hpp: a generalização do vectorsum.c.
+//
+// No vectorsum.c o rank 0 cria A e B, espalha com MPI_Scatter, cada rank
+// soma a sua parte e o rank 0 junta C com MPI_Gather: a comunicação custa
+// muito mais que a soma. Aqui cada rank gera e guarda só o seu bloco, as
+// expressões são fundidas num único passe e nada é juntado, a menos que
+// seja pedido (-p).
+//
+// Comando para executar no terminal
+// mpicxx -O3 -march=native -fopenmp -I../../../../../common vector_expr.cpp -o vector_expr
+// mpirun -np 4 --host localhost --oversubscribe ./vector_expr                 (10^7 doubles por vetor)
+// mpirun -np 4 --host localhost --oversubscribe ./vector_expr -n 100 -p       (junta e imprime C = A + B)
+// mpirun -np 3 --host localhost --oversubscribe ./vector_expr -n 1e8 -t 2 -r 10
+
+#include <mpi.h>
+#include <omp.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <unistd.h>
+#include "philox.h"
+#include "dist_vector.hpp"
+
+#define SEED 2024
+
+// Elemento i do vetor `stream`: inteiro entre 0 e 99, como o rand() % 100 do
+// vectorsum.c, mas dependente só do índice (cada rank gera o seu bloco)
+static double element(uint32_t stream, long long i) {
+    uint32_t r[4];
+    philox_block(SEED, stream, (uint64_t)i / 4, r);
+    return philox_to_range(r[i % 4], 0, 99);
+}
+
+// Melhor tempo de `reps` execuções de `op`, no rank mais lento
+template <class Op>
+double best_time(int reps, Op op) {
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        op();
+        double elapsed = MPI_Wtime() - start;
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int provided, rank, size;
+    // Só a thread principal chama MPI; as regiões OpenMP ficam entre chamadas
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    long long n = 10000000; // Tamanho dos vetores (qualquer n, não precisa ser múltiplo de size)
+    int reps = 5, print = 0, opt;
+    while ((opt = getopt(argc, argv, "n:r:t:p")) != -1) {
+        switch (opt) {
+        case 'n': n = (long long)std::strtod(optarg, NULL); break;
+        case 'r': reps = std::atoi(optarg); break;
+        case 't': omp_set_num_threads(std::atoi(optarg)); break;
+        case 'p': print = 1; break;
+        default:
+            if (rank == 0) std::fprintf(stderr, "Usage: %s [-n N] [-r reps] [-t threads] [-p]\n", argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    if (n <= 0 || reps <= 0) {
+        if (rank == 0) std::fprintf(stderr, "Invalid N or repetition count\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    dist::Vector<double> A(MPI_COMM_WORLD, n), B(MPI_COMM_WORLD, n), C(MPI_COMM_WORLD, n), D(MPI_COMM_WORLD, n);
+    dist::Vector<double> tmp1(MPI_COMM_WORLD, n), tmp2(MPI_COMM_WORLD, n);
+    A.generate([](long long i) { return element(0, i); });
+    B.generate([](long long i) { return element(1, i); });
+    D.generate([](long long i) { return element(2, i); });
+    tmp1 = 0.0;
+    tmp2 = 0.0;
+    C = 0.0;
+    const double a = 3.0;
+
+    if (rank == 0) {
+        std::printf("Vetores de %lld doubles (%.1f MB cada), %d processos, %d threads por processo\n", n,
+                    n * sizeof(double) / 1e6, size, omp_get_max_threads());
+        std::printf("%-28s %12s %10s\n", "operação", "tempo (ms)", "GB/s");
+    }
+    // Bytes movidos por elemento: cada vetor lido ou escrito conta 8
+    auto report = [&](const char *name, double seconds, int vectors) {
+        if (rank == 0)
+            std::printf("%-28s %12.3f %10.2f\n", name, seconds * 1e3, vectors * n * sizeof(double) / seconds / 1e9);
+    };
+
+    report("C = A + B", best_time(reps, [&] { C = A + B; }), 3);
+    report("C = a*A + B (axpy)", best_time(reps, [&] { C = a * A + B; }), 3);
+    report("C = A + a*B (triad)", best_time(reps, [&] { C = A + a * B; }), 3);
+    report("C = a*A + B*D (fundida)", best_time(reps, [&] { C = a * A + B * D; }), 4);
+    // Mesma conta em três passes, como sem expression templates: dois
+    // temporários escritos e relidos
+    report("C = a*A + B*D (3 passes)", best_time(reps, [&] {
+               tmp1 = a * A;
+               tmp2 = B * D;
+               C = tmp1 + tmp2;
+           }), 8);
+
+    // Conferência no próprio dono, sem juntar nada: maior diferença entre C
+    // e a conta feita elemento a elemento a partir dos geradores
+    C = a * A + B * D;
+    double max_error = 0.0;
+    for (long long i = 0; i < C.local_size(); i++) {
+        long long g = C.first() + i;
+        double expected = a * element(0, g) + element(1, g) * element(2, g);
+        max_error = std::fmax(max_error, std::fabs(C[i] - expected));
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &max_error, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    double total = dist::sum(C), ab = dist::dot(A, B);
+    if (rank == 0) {
+        std::printf("soma(C) = %.0f, A·B = %.0f, maior erro = %g\n", total, ab, max_error);
+    }
+
+    // Só com -p o resultado vai para o rank 0
+    if (print) {
+        C = A + B;
+        double start = MPI_Wtime();
+        std::vector<double> all = C.gather(0);
+        double elapsed = MPI_Wtime() - start;
+        if (rank == 0) {
+            std::printf("Vetor C (gather em %.3f ms):\n", elapsed * 1e3);
+            for (long long i = 0; i < n; i++) std::printf("%.0f ", all[i]);
+            std::printf("\n");
+        }
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include <quadmath.h>
+#include "deepzoom.h"
+
+int alloc_reference_orbit(ReferenceOrbit *orbit, int length) {
+    orbit->zr = (double *)malloc((size_t)length * sizeof(double));
+    orbit->zi = (double *)malloc((size_t)length * sizeof(double));
+    orbit->length = length;
+    if (orbit->zr == NULL || orbit->zi == NULL) {
+        free_reference_orbit(orbit);
+        return -1;
+    }
+    return 0;
+}
+
+void free_reference_orbit(ReferenceOrbit *orbit) {
+    free(orbit->zr);
+    free(orbit->zi);
+    orbit->zr = NULL;
+    orbit->zi = NULL;
+    orbit->length = 0;
+}
+
+int reference_orbit(ReferenceOrbit *orbit, const char *center_x, const char *center_y, int max_iter) {
+    if (alloc_reference_orbit(orbit, max_iter + 1) != 0) return -1;
+
+    __float128 cr = strtoflt128(center_x, NULL);
+    __float128 ci = strtoflt128(center_y, NULL);
+    __float128 zr = 0, zi = 0;
+
+    orbit->zr[0] = 0.0;
+    orbit->zi[0] = 0.0;
+    int n = 0;
+    while (n < max_iter) {
+        __float128 zr2 = zr * zr, zi2 = zi * zi;
+        if (zr2 + zi2 > 4) break;
+        zi = 2 * zr * zi + ci;
+        zr = zr2 - zi2 + cr;
+        n++;
+        orbit->zr[n] = (double)zr;
+        orbit->zi[n] = (double)zi;
+    }
+    orbit->length = n + 1;
+    return 0;
+}
+
+int perturbation_iterations(const ReferenceOrbit *orbit, double dcx, double dcy, int max_iter,
+                            double *zr_out, double *zi_out) {
+    double dzr = 0.0, dzi = 0.0;
+    int ref = 0;
+
+    for (int iteration = 0; iteration < max_iter; iteration++) {
+        double Zr = orbit->zr[ref], Zi = orbit->zi[ref];
+        double next_r = 2.0 * (Zr * dzr - Zi * dzi) + dzr * dzr - dzi * dzi + dcx;
+        double next_i = 2.0 * (Zr * dzi + Zi * dzr) + 2.0 * dzr * dzi + dcy;
+        dzr = next_r;
+        dzi = next_i;
+        ref++;
+
+        double zr = orbit->zr[ref] + dzr;
+        double zi = orbit->zi[ref] + dzi;
+        double mag = zr * zr + zi * zi;
+        if (mag > 4.0) {
+            *zr_out = zr;
+            *zi_out = zi;
+            return iteration + 1;
+        }
+
+        // Rebase: recomeça a referência usando o valor absoluto atual como delta
+        if (mag < dzr * dzr + dzi * dzi || ref == orbit->length - 1) {
+            dzr = zr;
+            dzi = zi;
+            ref = 0;
+        }
+    }
+    *zr_out = orbit->zr[ref] + dzr;
+    *zi_out = orbit->zi[ref] + dzi;
+    return max_iter;
+}
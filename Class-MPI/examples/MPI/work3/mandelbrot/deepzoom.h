@@ -0,0 +1,48 @@
+#ifndef DEEPZOOM_H
+#define DEEPZOOM_H
+
+/**
+ * Zoom profundo por teoria de perturbação.
+ *
+ * Uma única órbita de referência Z_n é calculada em alta precisão (__float128,
+ * ~34 dígitos) no centro da janela e guardada em double. Cada pixel itera só
+ * a diferença dz_n = z_n - Z_n, também em double:
+ *
+ *     dz_{n+1} = 2 Z_n dz_n + dz_n^2 + dc
+ *
+ * Assim, janelas menores que 1e-15 (onde x0/y0 em double já não se distinguem)
+ * continuam rápidas. O limite prático é ~1e-30 (precisão do centro) e ~1e-300
+ * (expoente do double usado nos deltas).
+ */
+
+typedef struct {
+    double *zr; // parte real de Z_n
+    double *zi; // parte imaginária de Z_n
+    int length; // número de pontos guardados (Z_0 = 0 incluso)
+} ReferenceOrbit;
+
+/**
+ * Calcula a órbita de referência do ponto (center_x, center_y), dados como
+ * strings decimais para não perder precisão na conversão. Retorna 0 em caso
+ * de sucesso e -1 se a memória não puder ser alocada.
+ */
+int reference_orbit(ReferenceOrbit *orbit, const char *center_x, const char *center_y, int max_iter);
+
+/**
+ * Aloca uma órbita vazia com espaço para `length` pontos (usada pelos ranks
+ * que recebem a órbita via MPI_Bcast). Retorna 0 em caso de sucesso.
+ */
+int alloc_reference_orbit(ReferenceOrbit *orbit, int length);
+
+void free_reference_orbit(ReferenceOrbit *orbit);
+
+/**
+ * Número de iterações até escapar do ponto centro + (dcx, dcy). Quando a
+ * órbita perturbada se aproxima mais de zero do que da referência (glitch),
+ * ou a referência acaba, o delta é "rebaseado" para o início da órbita.
+ * O valor absoluto de z no escape é devolvido em (zr, zi) para a coloração suave.
+ */
+int perturbation_iterations(const ReferenceOrbit *orbit, double dcx, double dcy, int max_iter,
+                            double *zr, double *zi);
+
+#endif // DEEPZOOM_H
@@ -1,19 +1,75 @@
+// Comando para gerar o executável:
+// make   (ou: mpicc mandelbrot_mpi.c deepzoom.c tilecache.c palette.c -o mandelbrot_mpi -lquadmath -lm)
+
+// Comando para executar
+// mpirun -np 4 ./mandelbrot_mpi
+// mpirun -np 4 ./mandelbrot_mpi -W 1920 -H 1080 -i 2000 -v -0.75,-0.1,-0.74,-0.09
+// Zoom profundo (perturbação), centro com quantos dígitos forem necessários:
+// (sem -i, max_iter cresce com a profundidade: 40000 em r = 1e-25)
+// mpirun -np 4 ./mandelbrot_mpi -c -0.743643887037158704752191506114774,0.131825904205311970493132056385139 -r 1e-25
+// Renderização progressiva (3 níveis) com cache de tiles em disco:
+// mpirun -np 4 ./mandelbrot_mpi -p 3 -C tile_cache
+// Outra paleta sobre os mesmos tiles (nada é recalculado):
+// mpirun -np 4 ./mandelbrot_mpi -C tile_cache -P fire -L 32
+
 #include <mpi.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
 #include <string.h> // Adiciona o cabeçalho string.h
+#include <unistd.h> // getopt
+#include "deepzoom.h"
+#include "tilecache.h"
+#include "palette.h"
 
-#define WIDTH 800
-#define HEIGHT 800
 #define MASTER 0
+#define BMP_HEADER_SIZE 54
+#define MAX_COORD_DIGITS 128
+#define DEFAULT_TILE_SIZE 64
+#define TILE_KEY_SIZE 512
+#define SMOOTH_EXTRA_ITERATIONS 3
+#define DEFAULT_MAX_ITER 1000
+#define DEEP_ITER_PER_DIGIT2 64 // zoom profundo sem -i: 64 * log10(1/r)^2 iterações
+
+// Parâmetros da renderização, todos configuráveis pela linha de comando
+typedef struct {
+    int width, height;
+    int max_iter;
+    double xi, yi, xf, yf;                  // janela (modo normal)
+    int deep;                               // 1 = zoom profundo por perturbação
+    char center_x[MAX_COORD_DIGITS];        // centro em alta precisão (modo deep)
+    char center_y[MAX_COORD_DIGITS];
+    double radius;                          // meia-altura da janela (modo deep)
+    int levels;                             // níveis de resolução (1 = sem progressivo)
+    int tile_size;                          // lado do tile em pixels
+    const char *cache_dir;                  // NULL = sem cache de tiles
+    const char *palette;                    // nome da paleta
+    float cycle;                            // iterações por ciclo da paleta
+    const char *output;
+} RenderParams;
 
+// Quantos tiles vieram do cache, foram preenchidos (borda dentro do conjunto) ou calculados
 typedef struct {
-    unsigned char r, g, b;
-} Pixel;
+    long long cached, filled, computed;
+} TileStats;
 
-void write_bmp(const char *filename, Pixel *img, int width, int height);
-void mandelbrot(Pixel *img, int width, int height, double xi, double yi, double xf, double yf, int max_iter);
+int parse_args(int argc, char *argv[], RenderParams *params, int rank);
+void bmp_header(unsigned char header[BMP_HEADER_SIZE], int width, int height);
+int bmp_row_size(int width);
+void pack_bmp_rows(const Pixel *img, unsigned char *out, int width, int height);
+int level_size(int size, int level);
+void tile_key_string(char *key, const RenderParams *params, int level, int x_start, int y_start,
+                     int tile_width, int tile_height);
+int coarse_uniform(float *value, float *scratch, const RenderParams *params, const TileCache *cache,
+                   int level, int x_start, int y_start, int tile_width, int tile_height);
+int border_inside(float *scratch, const RenderParams *params, const ReferenceOrbit *orbit,
+                  int level, int x_start, int y_start, int tile_width, int tile_height);
+void render_tile(float *mu, float *scratch, const RenderParams *params, const ReferenceOrbit *orbit,
+                 const TileCache *cache, int level, int tx, int ty, TileStats *stats);
+void mandelbrot(float *mu, const RenderParams *params, const ReferenceOrbit *orbit,
+                int level, int x_start, int y_start, int tile_width, int tile_height);
+float smooth_iteration(int iteration, double x, double y, double x0, double y0, int max_iter);
 
 int main(int argc, char *argv[]) {
     int num_procs, rank;
@@ -21,97 +77,473 @@ int main(int argc, char *argv[]) {
     MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-    int max_iter = 1000;
-    double xi = -2.5, yi = -1.0, xf = 1.0, yf = 1.0;
+    // Todos os ranks recebem o mesmo argv, então todos chegam ao mesmo resultado
+    RenderParams params;
+    if (parse_args(argc, argv, &params, rank) != 0) {
+        MPI_Finalize();
+        return 1;
+    }
+    int width = params.width, height = params.height;
 
-    int num_quadrants = 10 * num_procs;
-    int quadrant_height = HEIGHT / num_quadrants;
+    // No modo deep, o rank 0 calcula a órbita de referência em alta precisão
+    // e a distribui: os outros ranks só precisam dela em double.
+    ReferenceOrbit orbit = {NULL, NULL, 0};
+    if (params.deep) {
+        int length = 0;
+        if (rank == MASTER) {
+            if (reference_orbit(&orbit, params.center_x, params.center_y, params.max_iter) != 0) {
+                fprintf(stderr, "Error allocating reference orbit\n");
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            length = orbit.length;
+            printf("Master: Reference orbit has %d points\n", length);
+        }
+        MPI_Bcast(&length, 1, MPI_INT, MASTER, MPI_COMM_WORLD);
+        if (rank != MASTER && alloc_reference_orbit(&orbit, length) != 0) {
+            fprintf(stderr, "Rank %d: Error allocating reference orbit\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        MPI_Bcast(orbit.zr, length, MPI_DOUBLE, MASTER, MPI_COMM_WORLD);
+        MPI_Bcast(orbit.zi, length, MPI_DOUBLE, MASTER, MPI_COMM_WORLD);
+    }
+
+    // A paleta só entra no passo final de coloração, depois do cálculo
+    Palette palette;
+    palette_init(&palette, params.palette, params.cycle);
+
+    TileCache cache;
+    if (tile_cache_init(&cache, params.cache_dir) != 0) {
+        fprintf(stderr, "Rank %d: Error creating tile cache %s\n", rank, params.cache_dir);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
 
+    // A imagem é dividida em tiles quadrados; cada faixa de tiles (tile_size
+    // linhas) é a unidade de trabalho, distribuída de forma cíclica entre os
+    // ranks. Nenhum processo junta a imagem inteira: cada um escreve as suas
+    // faixas diretamente no arquivo, então o tamanho da imagem não depende da
+    // memória do rank 0.
+    int tile_size = params.tile_size;
+    int row_size = bmp_row_size(width);
+    MPI_Offset data_size = (MPI_Offset)row_size * height;
+
+    float *tile_mu = (float *)malloc((size_t)tile_size * tile_size * sizeof(float));
+    float *scratch = (float *)malloc((size_t)tile_size * tile_size * sizeof(float));
+    Pixel *tile_img = (Pixel *)malloc((size_t)tile_size * tile_size * sizeof(Pixel));
+    Pixel *band_img = (Pixel *)malloc((size_t)width * tile_size * sizeof(Pixel));
+    unsigned char *band_bmp = (unsigned char *)malloc((size_t)row_size * tile_size);
+    if (tile_mu == NULL || scratch == NULL || tile_img == NULL || band_img == NULL || band_bmp == NULL) {
+        fprintf(stderr, "Rank %d: Error allocating memory\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    MPI_File fh;
+    if (MPI_File_open(MPI_COMM_WORLD, params.output, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == MASTER) fprintf(stderr, "Error opening %s\n", params.output);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    // Trunca/estende o arquivo para o tamanho final (remove restos de execuções maiores)
+    MPI_File_set_size(fh, BMP_HEADER_SIZE + data_size);
+
+    // Somente o rank 0 escreve o cabeçalho
     if (rank == MASTER) {
-        Pixel *img = (Pixel *)malloc(WIDTH * HEIGHT * sizeof(Pixel));
-        if (img == NULL) {
-            fprintf(stderr, "Error allocating memory\n");
-            MPI_Abort(MPI_COMM_WORLD, 1);
+        unsigned char header[BMP_HEADER_SIZE];
+        bmp_header(header, width, height);
+        MPI_File_write_at(fh, 0, header, BMP_HEADER_SIZE, MPI_BYTE, MPI_STATUS_IGNORE);
+        printf("Master: Header written, rendering %dx%d (%d levels, %dx%d tiles, max_iter %d) on %d processes...\n",
+               width, height, params.levels, tile_size, tile_size, params.max_iter, num_procs);
+    }
+
+    TileStats stats = {0, 0, 0};
+
+    // Renderização progressiva: os níveis grossos (1/2^level da resolução) só
+    // alimentam o cache. No nível seguinte, tiles cuja região no nível grosso
+    // está toda dentro do conjunto são candidatos a preenchimento: calcula-se
+    // só a borda do tile e, se ela também está toda dentro, o interior é
+    // preenchido com max_iter (Mariani-Silver). Os níveis grossos custam
+    // cerca de 1/3 de um render completo; só compensa quando boa parte da
+    // imagem é interior do conjunto.
+    for (int level = params.levels - 1; level > 0; level--) {
+        int tiles_x = (level_size(width, level) + tile_size - 1) / tile_size;
+        int tiles_y = (level_size(height, level) + tile_size - 1) / tile_size;
+        for (int ty = rank; ty < tiles_y; ty += num_procs) {
+            for (int tx = 0; tx < tiles_x; tx++) {
+                render_tile(tile_mu, scratch, &params, &orbit, &cache, level, tx, ty, &stats);
+            }
         }
-        printf("Master: Sending tasks to workers...\n");
-        for (int i = 0; i < num_quadrants; i++) {
-            int worker_rank = i % (num_procs - 1) + 1;
-            double quadrant_yi = yi + (yf - yi) * (i * quadrant_height) / HEIGHT;
-            double quadrant_yf = yi + (yf - yi) * ((i + 1) * quadrant_height) / HEIGHT;
-            MPI_Send(&quadrant_yi, 1, MPI_DOUBLE, worker_rank, 0, MPI_COMM_WORLD);
-            MPI_Send(&quadrant_yf, 1, MPI_DOUBLE, worker_rank, 0, MPI_COMM_WORLD);
-            printf("Master: Sent quadrant %d to worker %d\n", i, worker_rank);
+        // O próximo nível lê do cache tiles gravados por outros ranks
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    // Nível final. MPI_File_write_at_all é coletiva: todos os ranks executam o
+    // mesmo número de rodadas, e quem não tem faixa na última rodada escreve 0 bytes.
+    int tiles_x = (width + tile_size - 1) / tile_size;
+    int tiles_y = (height + tile_size - 1) / tile_size;
+    int rounds = (tiles_y + num_procs - 1) / num_procs;
+    for (int round = 0; round < rounds; round++) {
+        int ty = round * num_procs + rank;
+        MPI_Offset offset = 0;
+        int count = 0;
+
+        if (ty < tiles_y) {
+            int row_start = ty * tile_size;
+            int row_end = row_start + tile_size < height ? row_start + tile_size : height;
+            int band_height = row_end - row_start;
+
+            for (int tx = 0; tx < tiles_x; tx++) {
+                int col_start = tx * tile_size;
+                int tile_width = col_start + tile_size < width ? tile_size : width - col_start;
+                render_tile(tile_mu, scratch, &params, &orbit, &cache, 0, tx, ty, &stats);
+                shade(tile_img, tile_mu, tile_width * band_height, params.max_iter, &palette);
+                for (int j = 0; j < band_height; j++) {
+                    memcpy(&band_img[(size_t)j * width + col_start], &tile_img[(size_t)j * tile_width],
+                           tile_width * sizeof(Pixel));
+                }
+            }
+            pack_bmp_rows(band_img, band_bmp, width, band_height);
+
+            // O BMP guarda as linhas de baixo para cima: as linhas [row_start, row_end)
+            // da imagem ocupam um bloco contíguo começando na linha height - row_end do arquivo.
+            offset = BMP_HEADER_SIZE + (MPI_Offset)(height - row_end) * row_size;
+            count = band_height * row_size;
         }
 
-        for (int i = 0; i < num_quadrants; i++) {
-            Pixel *quadrant_img = (Pixel *)malloc(WIDTH * quadrant_height * sizeof(Pixel));
-            int worker_rank = i % (num_procs - 1) + 1;
-            MPI_Recv(quadrant_img, WIDTH * quadrant_height * sizeof(Pixel), MPI_BYTE, worker_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            printf("Master: Received quadrant %d from worker %d\n", i, worker_rank);
-            for (int j = 0; j < quadrant_height; j++) {
-                memcpy(&img[(i * quadrant_height + j) * WIDTH], &quadrant_img[j * WIDTH], WIDTH * sizeof(Pixel));
+        MPI_File_write_at_all(fh, offset, band_bmp, count, MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+
+    long long local_stats[3] = {stats.cached, stats.filled, stats.computed}, total_stats[3];
+    MPI_Reduce(local_stats, total_stats, 3, MPI_LONG_LONG, MPI_SUM, MASTER, MPI_COMM_WORLD);
+    if (rank == MASTER) {
+        printf("Master: Tiles from cache: %lld, filled (border inside the set): %lld, computed: %lld\n",
+               total_stats[0], total_stats[1], total_stats[2]);
+    }
+
+    MPI_File_close(&fh);
+    free(tile_mu);
+    free(scratch);
+    free(tile_img);
+    free(band_img);
+    free(band_bmp);
+    free_reference_orbit(&orbit);
+
+    if (rank == MASTER) printf("Master: Done.\n");
+
+    MPI_Finalize();
+    return 0;
+}
+
+void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [-W width] [-H height] [-i max_iter] [-v xi,yi,xf,yf]\n"
+            "          [-c center_x,center_y -r radius] [-p levels -C cache_dir] [-t tile_size]\n"
+            "          [-P classic|fire|grey] [-L cycle]\n"
+            "          [-o output.bmp]\n"
+            "  -i  iterações máximas (padrão %d; no modo -c, %d * log10(1/r)^2 se maior)\n"
+            "  -v  janela no plano complexo (padrão -2.5,-1.0,1.0,1.0)\n"
+            "  -c  ativa o zoom profundo (perturbação) centrado neste ponto;\n"
+            "      as coordenadas são lidas com ~34 dígitos de precisão\n"
+            "  -r  meia-altura da janela no modo -c (padrão 1.0)\n"
+            "  -p  níveis de renderização progressiva (padrão 1 = desligado)\n"
+            "  -C  diretório do cache de tiles (obrigatório com -p > 1)\n"
+            "  -t  lado do tile em pixels, par (padrão %d)\n"
+            "  -P  paleta (padrão classic)\n"
+            "  -L  iterações por ciclo de cores (padrão 64)\n",
+            program, DEFAULT_MAX_ITER, DEEP_ITER_PER_DIGIT2, DEFAULT_TILE_SIZE);
+}
+
+// Lê as opções da linha de comando. Retorna 0 se tudo estiver certo.
+int parse_args(int argc, char *argv[], RenderParams *params, int rank) {
+    params->width = 800;
+    params->height = 800;
+    params->max_iter = DEFAULT_MAX_ITER;
+    params->xi = -2.5;
+    params->yi = -1.0;
+    params->xf = 1.0;
+    params->yf = 1.0;
+    params->deep = 0;
+    params->radius = 1.0;
+    params->levels = 1;
+    params->tile_size = DEFAULT_TILE_SIZE;
+    params->cache_dir = NULL;
+    params->palette = "classic";
+    params->cycle = 64.0f;
+    params->output = "mandelbrot.bmp";
+
+    int opt, max_iter_given = 0;
+    opterr = 0;
+    while ((opt = getopt(argc, argv, "W:H:i:v:c:r:p:C:t:P:L:o:")) != -1) {
+        switch (opt) {
+        case 'W': params->width = atoi(optarg); break;
+        case 'H': params->height = atoi(optarg); break;
+        case 'i':
+            params->max_iter = atoi(optarg);
+            max_iter_given = 1;
+            break;
+        case 'r': params->radius = atof(optarg); break;
+        case 'o': params->output = optarg; break;
+        case 'p': params->levels = atoi(optarg); break;
+        case 'C': params->cache_dir = optarg; break;
+        case 't': params->tile_size = atoi(optarg); break;
+        case 'P': params->palette = optarg; break;
+        case 'L': params->cycle = (float)atof(optarg); break;
+        case 'v':
+            if (sscanf(optarg, "%lf,%lf,%lf,%lf", &params->xi, &params->yi, &params->xf, &params->yf) != 4) {
+                if (rank == MASTER) fprintf(stderr, "Invalid view window: %s\n", optarg);
+                return -1;
             }
-            free(quadrant_img);
+            break;
+        case 'c': {
+            const char *comma = strchr(optarg, ',');
+            size_t len_x = comma ? (size_t)(comma - optarg) : 0;
+            if (comma == NULL || len_x >= MAX_COORD_DIGITS || strlen(comma + 1) >= MAX_COORD_DIGITS) {
+                if (rank == MASTER) fprintf(stderr, "Invalid center: %s\n", optarg);
+                return -1;
+            }
+            memcpy(params->center_x, optarg, len_x);
+            params->center_x[len_x] = '\0';
+            strcpy(params->center_y, comma + 1);
+            params->deep = 1;
+            break;
+        }
+        default:
+            if (rank == MASTER) usage(argv[0]);
+            return -1;
         }
+    }
+
+    // Quanto mais fundo o zoom, mais iterações os pontos perto da fronteira
+    // levam para escapar: com o padrão fixo, r = 1e-18 já sai todo preto
+    if (!max_iter_given && params->deep && params->radius > 0 && params->radius < 1.0) {
+        double digits = log10(1.0 / params->radius);
+        double scaled = DEEP_ITER_PER_DIGIT2 * digits * digits;
+        if (scaled > params->max_iter) params->max_iter = scaled < 1e9 ? (int)scaled : 1000000000;
+    }
+    if (params->width <= 0 || params->height <= 0 || params->max_iter <= 0 || params->radius <= 0) {
+        if (rank == MASTER) fprintf(stderr, "Width, height, max_iter and radius must be positive\n");
+        return -1;
+    }
+    if (params->tile_size < 2 || params->tile_size % 2 != 0 || params->levels < 1 || params->levels > 16) {
+        if (rank == MASTER) fprintf(stderr, "Tile size must be even and levels between 1 and 16\n");
+        return -1;
+    }
+    Palette probe;
+    if (palette_init(&probe, params->palette, 1.0f) != 0 || params->cycle <= 0) {
+        if (rank == MASTER) fprintf(stderr, "Unknown palette %s or invalid cycle\n", params->palette);
+        return -1;
+    }
+    // Os níveis grossos chegam ao nível seguinte pelo cache
+    if (params->levels > 1 && params->cache_dir == NULL) {
+        if (rank == MASTER) fprintf(stderr, "Progressive rendering (-p) requires a tile cache (-C)\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Tamanho da imagem no nível `level` (cada nível divide a resolução por 2)
+int level_size(int size, int level) {
+    return (size + (1 << level) - 1) >> level;
+}
 
-        printf("Master: Writing BMP file...\n");
-        write_bmp("mandelbrot.bmp", img, WIDTH, HEIGHT);
-        free(img);
-        printf("Master: Done.\n");
+// Descrição da região do plano complexo coberta por um tile, usada como chave do cache
+void tile_key_string(char *key, const RenderParams *params, int level, int x_start, int y_start,
+                     int tile_width, int tile_height) {
+    int step = 1 << level;
+    if (params->deep) {
+        double scale = 2.0 * params->radius / params->height;
+        snprintf(key, TILE_KEY_SIZE, "deep|%s|%s|%.12e|%.12e|%.12e|%d|%dx%d",
+                 params->center_x, params->center_y,
+                 ((double)x_start * step - 0.5 * params->width) * scale,
+                 ((double)y_start * step - 0.5 * params->height) * scale,
+                 scale * step, params->max_iter, tile_width, tile_height);
     } else {
-        while (1) {
-            MPI_Status status;
-            double quadrant_yi, quadrant_yf;
-            MPI_Recv(&quadrant_yi, 1, MPI_DOUBLE, MASTER, 0, MPI_COMM_WORLD, &status);
-            MPI_Recv(&quadrant_yf, 1, MPI_DOUBLE, MASTER, 0, MPI_COMM_WORLD, &status);
-            if (quadrant_yi == -1 && quadrant_yf == -1) break;
-
-            printf("Worker %d: Received task for quadrant (%f, %f)\n", rank, quadrant_yi, quadrant_yf);
-            Pixel *quadrant_img = (Pixel *)malloc(WIDTH * quadrant_height * sizeof(Pixel));
-            mandelbrot(quadrant_img, WIDTH, quadrant_height, xi, quadrant_yi, xf, quadrant_yf, max_iter);
-            MPI_Send(quadrant_img, WIDTH * quadrant_height * sizeof(Pixel), MPI_BYTE, MASTER, 0, MPI_COMM_WORLD);
-            printf("Worker %d: Sent result for quadrant (%f, %f)\n", rank, quadrant_yi, quadrant_yf);
-            free(quadrant_img);
+        double dx = (params->xf - params->xi) / params->width;
+        double dy = (params->yf - params->yi) / params->height;
+        snprintf(key, TILE_KEY_SIZE, "std|%.12e|%.12e|%.12e|%.12e|%d|%dx%d",
+                 params->xi + dx * x_start * step, params->yi + dy * y_start * step,
+                 dx * step, dy * step, params->max_iter, tile_width, tile_height);
+    }
+}
+
+// Verifica se a região do tile (tx, ty) no nível grosso seguinte tem contagem
+// constante. Com contagens suaves isso na prática só acontece dentro do conjunto,
+// que é justamente a parte cara do cálculo. A região inclui um pixel grosso de borda.
+// É só uma heurística para escolher candidatos (detalhes menores que um pixel
+// grosso escapam dela): quem decide é border_inside, no nível fino.
+int coarse_uniform(float *value, float *scratch, const RenderParams *params, const TileCache *cache,
+                   int level, int x_start, int y_start, int tile_width, int tile_height) {
+    int tile_size = params->tile_size;
+    int coarse = level + 1;
+    int ctx = (x_start / 2) / tile_size, cty = (y_start / 2) / tile_size;
+    int cx_start = ctx * tile_size, cy_start = cty * tile_size;
+    int cw = level_size(params->width, coarse) - cx_start;
+    int ch = level_size(params->height, coarse) - cy_start;
+    if (cw > tile_size) cw = tile_size;
+    if (ch > tile_size) ch = tile_size;
+
+    char key[TILE_KEY_SIZE];
+    tile_key_string(key, params, coarse, cx_start, cy_start, cw, ch);
+    if (!tile_cache_load(cache, tile_key(key), scratch, cw, ch, params->max_iter)) return 0;
+
+    int x0 = x_start / 2 - cx_start - 1, x1 = (x_start + tile_width - 1) / 2 - cx_start + 1;
+    int y0 = y_start / 2 - cy_start - 1, y1 = (y_start + tile_height - 1) / 2 - cy_start + 1;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > cw - 1) x1 = cw - 1;
+    if (y1 > ch - 1) y1 = ch - 1;
+
+    float first = scratch[(size_t)y0 * cw + x0];
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            if (scratch[(size_t)y * cw + x] != first) return 0;
         }
     }
+    *value = first;
+    return 1;
+}
 
-    MPI_Finalize();
-    return 0;
+// Produz as contagens suaves do tile (tx, ty) do nível `level`: do cache, a partir do
+// interior do conjunto (região grossa e borda fina dentro dele) ou calculando.
+int border_inside(float *scratch, const RenderParams *params, const ReferenceOrbit *orbit,
+                  int level, int x_start, int y_start, int tile_width, int tile_height);
+void render_tile(float *mu, float *scratch, const RenderParams *params, const ReferenceOrbit *orbit,
+                 const TileCache *cache, int level, int tx, int ty, TileStats *stats) {
+    int tile_size = params->tile_size;
+    int x_start = tx * tile_size, y_start = ty * tile_size;
+    int tile_width = level_size(params->width, level) - x_start;
+    int tile_height = level_size(params->height, level) - y_start;
+    if (tile_width > tile_size) tile_width = tile_size;
+    if (tile_height > tile_size) tile_height = tile_size;
+
+    char key_string[TILE_KEY_SIZE];
+    tile_key_string(key_string, params, level, x_start, y_start, tile_width, tile_height);
+    uint64_t key = tile_key(key_string);
+    if (tile_cache_load(cache, key, mu, tile_width, tile_height, params->max_iter)) {
+        stats->cached++;
+        return;
+    }
+
+    float value;
+    if (level + 1 < params->levels &&
+        coarse_uniform(&value, scratch, params, cache, level, x_start, y_start, tile_width, tile_height) &&
+        value >= params->max_iter &&
+        border_inside(scratch, params, orbit, level, x_start, y_start, tile_width, tile_height)) {
+        for (int i = 0; i < tile_width * tile_height; i++) mu[i] = value;
+        stats->filled++;
+    } else {
+        mandelbrot(mu, params, orbit, level, x_start, y_start, tile_width, tile_height);
+        stats->computed++;
+    }
+    tile_cache_store(cache, key, mu, tile_width, tile_height, params->max_iter);
 }
 
-void mandelbrot(Pixel *img, int width, int height, double xi, double yi, double xf, double yf, int max_iter) {
+// Calcula a borda do tile (as quatro faixas de um pixel, em scratch) e retorna 1
+// se todos os pixels dela ficam dentro do conjunto (contagem max_iter). Os pontos
+// que não escapam em max_iter iterações formam um conjunto sem buracos
+// ({c : |z_max_iter(c)| <= 2}, pelo princípio do máximo), então o interior do tile
+// também está dentro, exceto por canais de escape mais finos que um pixel que
+// atravessem a borda entre duas amostras.
+int border_inside(float *scratch, const RenderParams *params, const ReferenceOrbit *orbit,
+                  int level, int x_start, int y_start, int tile_width, int tile_height) {
+    int x_last = x_start + tile_width - 1, y_last = y_start + tile_height - 1;
+    int strips[4][4] = {
+        {x_start, y_start, tile_width, 1},           // cima
+        {x_start, y_last, tile_width, 1},            // baixo
+        {x_start, y_start, 1, tile_height},          // esquerda
+        {x_last, y_start, 1, tile_height},           // direita
+    };
+    for (int s = 0; s < 4; s++) {
+        int n = strips[s][2] * strips[s][3];
+        mandelbrot(scratch, params, orbit, level, strips[s][0], strips[s][1], strips[s][2], strips[s][3]);
+        for (int i = 0; i < n; i++) {
+            if (scratch[i] < params->max_iter) return 0;
+        }
+    }
+    return 1;
+}
+
+// Calcula as contagens suaves de um tile do nível `level`. As coordenadas são
+// derivadas do pixel global (x << level, y << level), então o resultado não
+// depende do número de processos nem do tamanho do tile. O kernel não sabe nada
+// de cores: a paleta é aplicada depois por shade().
+void mandelbrot(float *mu, const RenderParams *params, const ReferenceOrbit *orbit,
+                int level, int x_start, int y_start, int tile_width, int tile_height) {
+    int width = params->width, height = params->height, max_iter = params->max_iter;
     double x0, y0, x, y, xtemp;
-    int iteration;
-    for (int px = 0; px < width; px++) {
-        for (int py = 0; py < height; py++) {
-            x0 = xi + (xf - xi) * px / width;
-            y0 = yi + (yf - yi) * py / height;
-            x = 0.0;
-            y = 0.0;
-            iteration = 0;
-            while (x*x + y*y <= 4 && iteration < max_iter) {
-                xtemp = x*x - y*y + x0;
-                y = 2*x*y + y0;
-                x = xtemp;
-                iteration++;
-            }
-            Pixel *p = &img[py * width + px];
-            if (iteration == max_iter) {
-                p->r = 0;
-                p->g = 0;
-                p->b = 0;
+    // Modo deep: cada pixel é um deslocamento (dx, dy) em relação ao centro
+    double scale = 2.0 * params->radius / height;
+    double center_x = params->deep ? atof(params->center_x) : 0.0;
+    double center_y = params->deep ? atof(params->center_y) : 0.0;
+
+    for (int ty = 0; ty < tile_height; ty++) {
+        int py = (y_start + ty) << level;
+        for (int tx = 0; tx < tile_width; tx++) {
+            int px = (x_start + tx) << level;
+            int iteration;
+            if (params->deep) {
+                double dx = (px - 0.5 * width) * scale;
+                double dy = (py - 0.5 * height) * scale;
+                iteration = perturbation_iterations(orbit, dx, dy, max_iter, &x, &y);
+                // Depois do escape, o valor absoluto em double basta para as iterações extras
+                x0 = center_x + dx;
+                y0 = center_y + dy;
             } else {
-                p->r = (iteration % 256);
-                p->g = (iteration % 256);
-                p->b = (iteration % 256);
+                x0 = params->xi + (params->xf - params->xi) * px / width;
+                y0 = params->yi + (params->yf - params->yi) * py / height;
+                x = 0.0;
+                y = 0.0;
+                iteration = 0;
+                while (x*x + y*y <= 4 && iteration < max_iter) {
+                    xtemp = x*x - y*y + x0;
+                    y = 2*x*y + y0;
+                    x = xtemp;
+                    iteration++;
+                }
             }
+            mu[(size_t)ty * tile_width + tx] = smooth_iteration(iteration, x, y, x0, y0, max_iter);
+        }
+    }
+}
+
+// Iteração contínua mu = n + 1 - log2(ln|z_n|). Algumas iterações extras após o
+// escape deixam |z| grande o bastante para a fórmula não ter degraus visíveis.
+float smooth_iteration(int iteration, double x, double y, double x0, double y0, int max_iter) {
+    if (iteration >= max_iter) return (float)max_iter;
+
+    double xtemp;
+    for (int k = 0; k < SMOOTH_EXTRA_ITERATIONS; k++) {
+        xtemp = x*x - y*y + x0;
+        y = 2*x*y + y0;
+        x = xtemp;
+    }
+    double log_modulus = 0.5 * log(x*x + y*y);
+    double mu = iteration + SMOOTH_EXTRA_ITERATIONS + 1 - log2(log_modulus);
+    if (mu < 0.0) mu = 0.0;
+    // Um ponto de fora nunca pode parecer "dentro" no passo de coloração
+    if (mu > max_iter - 0.01) mu = max_iter - 0.01;
+    return (float)mu;
+}
+
+// Cada linha do BMP é alinhada em múltiplos de 4 bytes
+int bmp_row_size(int width) {
+    return (3 * width + 3) & ~3;
+}
+
+// Converte um bloco de linhas para o layout do arquivo: de baixo para cima, BGR e com padding
+void pack_bmp_rows(const Pixel *img, unsigned char *out, int width, int height) {
+    int row_size = bmp_row_size(width);
+    for (int i = 0; i < height; i++) {
+        unsigned char *row = out + (size_t)i * row_size;
+        const Pixel *src = &img[(size_t)(height - i - 1) * width];
+        for (int j = 0; j < width; j++) {
+            row[3 * j] = src[j].b;
+            row[3 * j + 1] = src[j].g;
+            row[3 * j + 2] = src[j].r;
         }
+        memset(row + 3 * width, 0, row_size - 3 * width);
     }
 }
 
-void write_bmp(const char *filename, Pixel *img, int width, int height) {
-    FILE *f;
-    int filesize = 54 + 3 * width * height;
+void bmp_header(unsigned char header[BMP_HEADER_SIZE], int width, int height) {
     unsigned char bmpfileheader[14] = {
         'B', 'M',
         0, 0, 0, 0,
@@ -130,37 +562,26 @@ void write_bmp(const char *filename, Pixel *img, int width, int height) {
         0, 0, 0, 0,
         0, 0, 0, 0
     };
-    
-    int filesize_offset = filesize;
-    bmpfileheader[2] = (unsigned char)(filesize_offset);
-    bmpfileheader[3] = (unsigned char)(filesize_offset >> 8);
-    bmpfileheader[4] = (unsigned char)(filesize_offset >> 16);
-    bmpfileheader[5] = (unsigned char)(filesize_offset >> 24);
-    
+
+    // O campo de tamanho do BMP tem 32 bits; imagens maiores que 4 GiB ficam com o valor truncado
+    unsigned int filesize = (unsigned int)(BMP_HEADER_SIZE + (unsigned long long)bmp_row_size(width) * height);
+    bmpfileheader[2] = (unsigned char)(filesize);
+    bmpfileheader[3] = (unsigned char)(filesize >> 8);
+    bmpfileheader[4] = (unsigned char)(filesize >> 16);
+    bmpfileheader[5] = (unsigned char)(filesize >> 24);
+
     int width_offset = width;
     bmpinfoheader[4] = (unsigned char)(width_offset);
     bmpinfoheader[5] = (unsigned char)(width_offset >> 8);
     bmpinfoheader[6] = (unsigned char)(width_offset >> 16);
     bmpinfoheader[7] = (unsigned char)(width_offset >> 24);
-    
+
     int height_offset = height;
     bmpinfoheader[8] = (unsigned char)(height_offset);
     bmpinfoheader[9] = (unsigned char)(height_offset >> 8);
     bmpinfoheader[10] = (unsigned char)(height_offset >> 16);
     bmpinfoheader[11] = (unsigned char)(height_offset >> 24);
-    
-    f = fopen(filename, "wb");
-    fwrite(bmpfileheader, 1, 14, f);
-    fwrite(bmpinfoheader, 1, 40, f);
-    
-    for (int i = 0; i < height; i++) {
-        for (int j = 0; j < width; j++) {
-            Pixel p = img[(height - i - 1) * width + j];
-            unsigned char color[3] = {p.b, p.g, p.r};
-            fwrite(color, 1, 3, f);
-        }
-    }
-    
-    fclose(f);
-}
 
+    memcpy(header, bmpfileheader, 14);
+    memcpy(header + 14, bmpinfoheader, 40);
+}
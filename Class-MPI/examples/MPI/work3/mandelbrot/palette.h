@@ -0,0 +1,41 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+/**
+ * Paletas e passo de coloração.
+ *
+ * O kernel de cálculo só produz contagens suaves (float, iteração contínua
+ * mu = n + 1 - log2(ln|z|)); a cor é aplicada depois, num passo separado e
+ * vetorizável que consulta uma tabela (LUT) e interpola entre entradas
+ * vizinhas. Trocar de paleta não exige recalcular nada: com o cache de
+ * tiles, uma nova paleta custa só este passo.
+ */
+
+#define PALETTE_SIZE 1024 // potência de 2: o índice dá a volta com uma máscara
+
+typedef struct {
+    unsigned char r, g, b;
+} Pixel;
+
+// LUT em formato SoA (um vetor por canal) para o laço de coloração vetorizar
+typedef struct {
+    float r[PALETTE_SIZE];
+    float g[PALETTE_SIZE];
+    float b[PALETTE_SIZE];
+    float density; // entradas da LUT por iteração
+} Palette;
+
+/**
+ * Monta a paleta `name` ("classic", "fire" ou "grey") com um ciclo de cores
+ * a cada `cycle` iterações. Retorna 0 em caso de sucesso e -1 se o nome não
+ * for conhecido.
+ */
+int palette_init(Palette *palette, const char *name, float cycle);
+
+/**
+ * Converte `n` contagens suaves em cores. Pontos com mu >= max_iter
+ * pertencem ao conjunto e ficam pretos.
+ */
+void shade(Pixel *img, const float *mu, int n, int max_iter, const Palette *palette);
+
+#endif // PALETTE_H
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tilecache.h"
+
+#define TILE_PATH_SIZE 512
+
+uint64_t tile_key(const char *description) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (const unsigned char *c = (const unsigned char *)description; *c; c++) {
+        hash ^= *c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+int tile_cache_init(TileCache *cache, const char *dir) {
+    cache->dir = dir;
+    if (dir == NULL) return 0;
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) return -1;
+    return 0;
+}
+
+static void tile_path(char *path, const TileCache *cache, uint64_t key) {
+    snprintf(path, TILE_PATH_SIZE, "%s/%016llx.tile", cache->dir, (unsigned long long)key);
+}
+
+int tile_cache_load(const TileCache *cache, uint64_t key, float *mu,
+                    int width, int height, int max_iter) {
+    if (cache->dir == NULL) return 0;
+
+    char path[TILE_PATH_SIZE];
+    tile_path(path, cache, key);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    size_t data_size = (size_t)width * height * sizeof(float);
+    size_t file_size = sizeof(TileHeader) + data_size;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != file_size) {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+
+    // Confere o cabeçalho: colisões de hash ou arquivos de outra versão são ignorados
+    const TileHeader *header = (const TileHeader *)map;
+    int found = memcmp(header->magic, TILE_MAGIC, sizeof(header->magic)) == 0 &&
+                header->key == key && header->width == width &&
+                header->height == height && header->max_iter == max_iter;
+    if (found) memcpy(mu, (const char *)map + sizeof(TileHeader), data_size);
+
+    munmap(map, file_size);
+    return found;
+}
+
+int tile_cache_store(const TileCache *cache, uint64_t key, const float *mu,
+                     int width, int height, int max_iter) {
+    if (cache->dir == NULL) return 0;
+
+    char path[TILE_PATH_SIZE], tmp_path[TILE_PATH_SIZE + 32];
+    tile_path(path, cache, key);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", path, (long)getpid());
+
+    TileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TILE_MAGIC, sizeof(header.magic));
+    header.key = key;
+    header.width = width;
+    header.height = height;
+    header.max_iter = max_iter;
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (f == NULL) return -1;
+    size_t n = (size_t)width * height;
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+             fwrite(mu, sizeof(float), n, f) == n;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+#include <stdint.h>
+
+/**
+ * Cache de tiles em disco.
+ *
+ * Cada tile é um arquivo <dir>/<chave>.tile com um cabeçalho fixo
+ * seguido das contagens suaves (float) em row-major, exatamente como ficam na
+ * memória. A leitura é feita com mmap, sem parsing.
+ *
+ * A chave é um hash da região do plano complexo coberta pelo tile (origem,
+ * espaçamento entre pixels, dimensões e max_iter), e não da janela inteira:
+ * janelas diferentes que caem na mesma grade (re-render, pan em múltiplos do
+ * tile, zoom ancorado no canto por potências de 2) reaproveitam os tiles, e o
+ * nível 1 de um zoom 2x é o nível 0 da janela anterior.
+ *
+ * Em várias máquinas o diretório precisa estar num sistema de arquivos
+ * compartilhado, pois os níveis grossos são lidos por outros ranks.
+ */
+
+#define TILE_MAGIC "MANDTIL2" // versão 2: contagens suaves em float
+
+typedef struct {
+    char magic[8];
+    uint64_t key;
+    int32_t width;
+    int32_t height;
+    int32_t max_iter;
+    int32_t reserved;
+} TileHeader;
+
+typedef struct {
+    const char *dir; // NULL = cache desativado
+} TileCache;
+
+/**
+ * Monta a chave de um tile a partir da descrição textual da sua região
+ * (ver tile_key_string em mandelbrot_mpi.c). Hash FNV-1a de 64 bits.
+ */
+uint64_t tile_key(const char *description);
+
+/**
+ * Cria o diretório do cache, se necessário. Retorna 0 em caso de sucesso.
+ */
+int tile_cache_init(TileCache *cache, const char *dir);
+
+/**
+ * Procura o tile no cache e copia as contagens para `mu`.
+ * Retorna 1 se encontrou, 0 caso contrário (inclusive arquivo inválido).
+ */
+int tile_cache_load(const TileCache *cache, uint64_t key, float *mu,
+                    int width, int height, int max_iter);
+
+/**
+ * Grava o tile. A escrita vai para um arquivo temporário que depois é
+ * renomeado, então leitores concorrentes nunca veem um tile pela metade.
+ */
+int tile_cache_store(const TileCache *cache, uint64_t key, const float *mu,
+                     int width, int height, int max_iter);
+
+#endif // TILECACHE_H
@@ -0,0 +1,195 @@
+// Produto escalar e GEMV de verdade, com os kernels de common/dot_kernels.h.
+//
+// first.c e second.c calculam sum += a[i]*b[i] com N = 10 e N = 100, em int,
+// com printf (e, no second.c, um laço vazio de um milhão de iterações e
+// códigos ANSI) a cada iteração: o que se mede ali é o printf. Aqui os
+// vetores têm tamanho de execução, o laço é só aritmética e o resultado é
+// comparado com uma referência em precisão quádrupla.
+//
+// Comando para gerar o executável:
+// gcc -O3 -march=native -fopenmp -I../../../../common dot_bench.c -o dot_bench -lm -lquadmath
+//
+// Comando para executar
+// ./dot_bench                           (n = 10^7, GEMV 4096 x 4096, threads do OMP_NUM_THREADS)
+// ./dot_bench -n 1e8 -t 8 -r 10
+// ./dot_bench -m 20000 -k 1000          (GEMV 20000 x 1000)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <math.h>
+#include <omp.h>
+#include "philox.h"      // gerador baseado em contador (pasta common/ na raiz)
+#include "dot_kernels.h" // kernels dot/GEMV (pasta common/ na raiz)
+
+#define SEED 2024
+// Perturbação do conjunto mal condicionado: b[n/2 + i] = -b[i] + 2^-PERTURB_BITS * ruído
+#define PERTURB_BITS 36
+
+// Valor em [-1, 1) do elemento i do vetor `stream`
+static double element(uint32_t stream, long long i) {
+    uint32_t r[4];
+    philox_block(SEED, stream, (uint64_t)i / 4, r);
+    return 2.0 * philox_to_unit(r[i % 4]) - 1.0;
+}
+
+// Soma em árvore dos produtos exatos (p + erro do FMA) em __float128: a
+// referência contra a qual os modos são medidos
+static __float128 exact_dot(const double *a, const double *b, long long n) {
+    if (n <= 64) {
+        __float128 s = 0;
+        for (long long i = 0; i < n; i++) {
+            double p = a[i] * b[i];
+            s += (__float128)p + (__float128)fma(a[i], b[i], -p);
+        }
+        return s;
+    }
+    return exact_dot(a, b, n / 2) + exact_dot(a + n / 2, b + n / 2, n - n / 2);
+}
+
+// O padrão ingênuo: cada thread acumula direto no seu parcial, em memória.
+// Sem padding, os parciais de 8 threads dividem uma linha de cache
+static double dot_partials_loop(const double *a, const double *b, long long n, int padded) {
+    static double plain[DOT_MAX_THREADS];
+    static DotPartial padded_partials[DOT_MAX_THREADS];
+    int team = omp_get_max_threads();
+    if (team > DOT_MAX_THREADS) team = DOT_MAX_THREADS;
+    #pragma omp parallel num_threads(team)
+    {
+        int t = omp_get_thread_num();
+        long long lo, hi;
+        dot_split(n, DOT_LANES, t, omp_get_num_threads(), &lo, &hi);
+        double *slot = padded ? &padded_partials[t].sum : &plain[t];
+        *slot = 0.0;
+        for (long long i = lo; i < hi; i++) *slot += a[i] * b[i];
+        #pragma omp single
+        team = omp_get_num_threads();
+    }
+    double sum = 0.0;
+    for (int t = 0; t < team; t++) sum += padded ? padded_partials[t].sum : plain[t];
+    return sum;
+}
+
+// Melhor tempo de `reps` execuções; o último resultado fica em *result
+#define BEST_TIME(reps, result, expr)                                                                      \
+    ({                                                                                                     \
+        double best_ = 1e300;                                                                              \
+        for (int r_ = 0; r_ < (reps); r_++) {                                                              \
+            double start_ = omp_get_wtime();                                                               \
+            *(result) = (expr);                                                                            \
+            double elapsed_ = omp_get_wtime() - start_;                                                    \
+            if (elapsed_ < best_) best_ = elapsed_;                                                        \
+        }                                                                                                  \
+        best_;                                                                                             \
+    })
+
+static void report(const char *name, double seconds, long long n, double value, __float128 exact) {
+    double rel = exact != 0 ? fabs((double)(((__float128)value - exact) / exact)) : fabs(value);
+    printf("%-30s %10.3f %9.2f %9.2f %12.3e\n", name, seconds * 1e3, 16.0 * n / seconds / 1e9,
+           2.0 * n / seconds / 1e9, rel);
+}
+
+int main(int argc, char *argv[]) {
+    long long n = 10000000, m = 4096, k = 4096;
+    int reps = 5, opt;
+    while ((opt = getopt(argc, argv, "n:m:k:t:r:")) != -1) {
+        switch (opt) {
+        case 'n': n = (long long)strtod(optarg, NULL); break;
+        case 'm': m = (long long)strtod(optarg, NULL); break;
+        case 'k': k = (long long)strtod(optarg, NULL); break;
+        case 't': omp_set_num_threads(atoi(optarg)); break;
+        case 'r': reps = atoi(optarg); break;
+        default:
+            fprintf(stderr, "Usage: %s [-n N] [-m gemv_rows] [-k gemv_cols] [-t threads] [-r reps]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 2 || m <= 0 || k <= 0 || reps <= 0) {
+        fprintf(stderr, "Invalid size or repetition count\n");
+        return 1;
+    }
+
+    double *a = aligned_alloc(DOT_CACHE_LINE, (n * sizeof(double) + 63) / 64 * 64);
+    double *b = aligned_alloc(DOT_CACHE_LINE, (n * sizeof(double) + 63) / 64 * 64);
+    double *A = aligned_alloc(DOT_CACHE_LINE, (m * k * sizeof(double) + 63) / 64 * 64);
+    double *x = aligned_alloc(DOT_CACHE_LINE, (k * sizeof(double) + 63) / 64 * 64);
+    double *y = aligned_alloc(DOT_CACHE_LINE, (m * sizeof(double) + 63) / 64 * 64);
+    double *y_serial = malloc(m * sizeof(double));
+    if (!a || !b || !A || !x || !y || !y_serial) {
+        fprintf(stderr, "Error allocating memory\n");
+        return 1;
+    }
+
+    printf("n = %lld, %d threads, melhor de %d\n", n, omp_get_max_threads(), reps);
+    const char *names[] = {"rápido (FMA, 32 lanes)", "compensado (Kahan/Dot2)", "em árvore (pairwise)"};
+    const DotMode modes[] = {DOT_FAST, DOT_KAHAN, DOT_PAIRWISE};
+
+    for (int set = 0; set < 2; set++) {
+        // Primeiro toque com a divisão dos kernels. O conjunto 1 tem a segunda
+        // metade quase cancelando a primeira: a soma verdadeira é ~2^-36 da
+        // soma dos |a*b| (condição ~10^15 com n = 10^7)
+        #pragma omp parallel
+        {
+            long long lo, hi;
+            dot_split(n, DOT_LANES, omp_get_thread_num(), omp_get_num_threads(), &lo, &hi);
+            for (long long i = lo; i < hi; i++) {
+                long long j = set == 1 && i >= n / 2 ? i - n / 2 : i;
+                a[i] = element(0, j);
+                b[i] = element(1, j);
+                if (set == 1 && i >= n / 2) b[i] = -b[i] + ldexp(element(2, i), -PERTURB_BITS);
+            }
+        }
+        __float128 exact = exact_dot(a, b, n);
+        double abs_sum = 0.0;
+        for (long long i = 0; i < n; i++) abs_sum += fabs(a[i] * b[i]);
+
+        printf("\n%s: a·b = %.17g, condição = %.2e\n", set == 0 ? "uniforme em [-1, 1)" : "mal condicionado",
+               (double)exact, 2.0 * abs_sum / fabs((double)exact));
+        printf("%-30s %10s %9s %9s %12s\n", "kernel", "tempo (ms)", "GB/s", "GFLOP/s", "erro rel.");
+        double value;
+        for (int md = 0; md < 3; md++) {
+            double t = BEST_TIME(reps, &value, dot(modes[md], a, b, n));
+            report(names[md], t, n, value, exact);
+        }
+        if (set == 0) {
+            double t = BEST_TIME(reps, &value, dot_partials_loop(a, b, n, 0));
+            report("parciais em memória, sem pad", t, n, value, exact);
+            t = BEST_TIME(reps, &value, dot_partials_loop(a, b, n, 1));
+            report("parciais em memória, com pad", t, n, value, exact);
+        }
+    }
+
+    // GEMV: primeiro toque de A pelas linhas de cada thread
+    #pragma omp parallel
+    {
+        long long lo, hi;
+        dot_split(m, DOT_GEMV_ROWS, omp_get_thread_num(), omp_get_num_threads(), &lo, &hi);
+        for (long long i = lo; i < hi; i++) {
+            for (long long j = 0; j < k; j++) A[i * k + j] = element(3, i * k + j);
+        }
+    }
+    for (long long j = 0; j < k; j++) x[j] = element(4, j);
+    for (long long i = 0; i < m; i++) y_serial[i] = dot_range(DOT_FAST, A + i * k, x, k);
+
+    printf("\nGEMV %lld x %lld (%.1f MB)\n", m, k, m * k * sizeof(double) / 1e6);
+    printf("%-30s %10s %9s %9s %12s\n", "kernel", "tempo (ms)", "GB/s", "GFLOP/s", "confere");
+    for (int md = 0; md < 3; md++) {
+        int dummy;
+        double t = BEST_TIME(reps, &dummy, (gemv(modes[md], A, x, y, m, k), 0));
+        // O modo rápido tem de bater bit a bit com a versão serial
+        long long diff = 0;
+        for (long long i = 0; i < m; i++) diff += modes[md] == DOT_FAST ? y[i] != y_serial[i]
+                                                                       : fabs(y[i] - y_serial[i]) > 1e-12;
+        printf("%-30s %10.3f %9.2f %9.2f %12s\n", names[md], t * 1e3, 8.0 * m * k / t / 1e9, 2.0 * m * k / t / 1e9,
+               diff == 0 ? "ok" : "ERRO");
+    }
+
+    free(a);
+    free(b);
+    free(A);
+    free(x);
+    free(y);
+    free(y_serial);
+    return 0;
+}
@@ -1,14 +1,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <omp.h>
+#include "progress.h" // barra de progresso (pasta common/ na raiz)
+
+// Comando para gerar o executável:
+// gcc -O2 -fopenmp -pthread -I../../../../common second.c -o second
 
 #define N 100  // Aumentar o número de iterações
+#define WORK 1000000 // Iterações do processamento simulado por elemento
+
+// Processamento simulado: volatile para o compilador não remover o laço
+static void simulate_work(void) {
+    for (volatile int j = 0; j < WORK; j++);
+}
 
 int main() {
     int sum = 0;
     int a[N], b[N];
     int num_threads = 4; // Configurar o número de threads
-    int chunk_size = N / num_threads;
 
     omp_set_num_threads(num_threads);
 
@@ -18,42 +27,47 @@ int main() {
         b[i] = 2 * i; // Apenas um exemplo de inicialização
     }
 
-    // Imprime a configuração visual das barras de progresso
-    printf("Progresso:\n");
-    for (int t = 0; t < num_threads; t++) {
-        printf("Thread %d: [", t);
-        for (int i = 0; i < chunk_size; i++) {
-            printf("=");
-        }
-        printf("]\n");
+    // Barra de progresso: cada thread só incrementa o próprio contador (numa
+    // linha de cache só dela) e uma thread de relatório desenha as barras 10
+    // vezes por segundo. Antes cada iteração movia o cursor com códigos ANSI
+    // e chamava fflush três vezes, todas as threads disputando o stdout.
+    Progress progress;
+    if (progress_start(&progress, "Progresso", N, num_threads, 1) != 0) {
+        fprintf(stderr, "Erro ao iniciar a barra de progresso\n");
+        return 1;
     }
-    printf("\n");
+    // Com schedule(static), a thread t fica com um bloco contíguo de N / num_threads (+1)
+    for (int t = 0; t < num_threads; t++) progress_slot_total(&progress, t, N / num_threads + (t < N % num_threads));
 
     // Processamento paralelo com OpenMP
-    #pragma omp parallel for reduction(+:sum)
+    double start = omp_get_wtime();
+    #pragma omp parallel for schedule(static) reduction(+:sum)
     for (int i = 0; i < N; i++) {
         // Simula processamento
-        for (int j = 0; j < 1000000; j++);
-
-        // Atualiza a barra de progresso da thread
-        int thread_id = omp_get_thread_num();
-        printf("\033[%dA", num_threads - thread_id); // Move o cursor para cima
-        printf("\033[%dC", chunk_size + 2); // Move o cursor para a direita
-        fflush(stdout); // Limpa o buffer de saída
-        printf("*"); // Marca o progresso
-        fflush(stdout); // Limpa o buffer de saída
-        printf("\033[%dB", num_threads - thread_id); // Move o cursor para baixo
-        fflush(stdout); // Limpa o buffer de saída
+        simulate_work();
 
         // Processamento real
         sum += a[i] * b[i];
+
+        // Atualiza o contador da thread (um load e um store, sem printf)
+        progress_add(&progress, omp_get_thread_num(), 1);
     }
+    double with_progress = omp_get_wtime() - start;
+    progress_finish(&progress);
 
-    // Finaliza a barra de progresso
-    printf("\n");
+    // O mesmo laço sem progresso, para comparar o custo
+    int check = 0;
+    start = omp_get_wtime();
+    #pragma omp parallel for schedule(static) reduction(+:check)
+    for (int i = 0; i < N; i++) {
+        simulate_work();
+        check += a[i] * b[i];
+    }
+    double without_progress = omp_get_wtime() - start;
 
     // Imprime o resultado final
     printf("A soma é: %d\n", sum);
+    printf("Tempo com progresso: %.3f s, sem progresso: %.3f s\n", with_progress, without_progress);
 
-    return 0;
+    return sum == check ? 0 : 1;
 }
@@ -1,79 +1,146 @@
 // Comando para gerar o executável:
-// gcc -fopenmp trabalho_openMP_Franklin.c -lm -o trabalho
+// g++ -O3 -march=native -fopenmp-simd -c ../../../../common/stats_kernels.cpp
+// gcc -O3 -march=native -fopenmp -I../../../../common trabalho_openMP_Franklin.c stats_kernels.o -lm -o trabalho
 
 // explicação sobre a flag -lm:
-// math.h is not a part of the standard C library, so you have to link to it! 
+// math.h is not a part of the standard C library, so you have to link to it!
 // link da explicação: https://stackoverflow.com/questions/44175151/what-is-the-meaning-of-lm-in-gcc
 
 // Comando para executar
-// ./trabalho
+// ./trabalho                          (matriz 100x100, 4 threads)
+// ./trabalho -n 20000 -t 8            (matriz 20000x20000, 8 threads)
+// ./trabalho -n 2000 -T trace.txt     (grava o trace por thread em trace.txt)
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
 #include <math.h>
 #include <omp.h>
-
-#define N 100
-
-int main() {
-    int sum = 0;
-    int zero_count = 0;
-    int a[N][N];
-    float media = 0;
-    float variance_sum = 0;
-    float desvio_p = 0;
-
-    omp_set_num_threads(4);
-
-    // Inicializa a matriz
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            a[i][j] = rand() % 100; // Gera números aleatórios
+#include "philox.h"        // gerador baseado em contador (pasta common/ na raiz)
+#include "running_stats.h" // Welford/Chan (pasta common/ na raiz)
+#include "stats_kernels.h" // kernels SIMD (AVX2/AVX-512) da pasta common/
+
+#define DEFAULT_N 100
+#define DEFAULT_THREADS 4
+#define SEED 2024 // mesma matriz em toda execução, como o rand() sem srand()
+
+// Operações de ponto flutuante por elemento no passe único: soma, desvio
+// em relação à média do bloco, quadrado e acúmulo do M2
+#define FLOPS_PER_ELEMENT 4
+
+// A cláusula reduction foi escolhida, pois cria uma instância
+// local da variável para cada thread, e cada thread realiza
+// a operação sobre sua própria instância.
+// Ao final, os resultados de todas as threads são combinados.
+// Isso evita condições de corrida.
+// explicação página 53 do PDF: IPPD-Aula8-OpenMP - IPPD-Aula8-OpenMP
+// Aqui a operação é declarada pelo usuário: a instância local é um
+// RunningStats e a combinação é a fórmula de Chan
+#pragma omp declare reduction(merge : RunningStats : running_stats_merge(&omp_out, &omp_in)) \
+    initializer(running_stats_init(&omp_priv))
+
+// Um evento do trace: qual thread processou qual linha e quando
+typedef struct {
+    int thread;
+    int row;
+    double start, end;
+} TraceEvent;
+
+// Buffer de trace de uma thread. Cada thread só escreve no seu; alinhado a
+// 64 bytes (e alocado com aligned_alloc), cada buffer ocupa uma linha de
+// cache inteira e dois buffers nunca dividem a mesma linha
+#define TRACE_CACHE_LINE 64
+typedef struct {
+    _Alignas(TRACE_CACHE_LINE) TraceEvent *events;
+    int count;
+} TraceBuffer;
+
+int main(int argc, char *argv[]) {
+    int n = DEFAULT_N;
+    int threads = DEFAULT_THREADS;
+    const char *trace_file = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:T:")) != -1) {
+        switch (opt) {
+        case 'n': n = atoi(optarg); break;
+        case 't': threads = atoi(optarg); break;
+        case 'T': trace_file = optarg; break;
+        default:
+            fprintf(stderr, "Usage: %s [-n N] [-t threads] [-T trace.txt]\n", argv[0]);
+            return 1;
         }
     }
+    if (n <= 0 || threads <= 0) {
+        fprintf(stderr, "Invalid N or thread count\n");
+        return 1;
+    }
+    omp_set_num_threads(threads);
+
+    // Matriz no heap: o tamanho vem da linha de comando e não cabe na pilha
+    size_t elements = (size_t)n * n;
+    int *a = (int *)malloc(elements * sizeof(int));
+    if (a == NULL) {
+        fprintf(stderr, "Error allocating %dx%d matrix\n", n, n);
+        return 1;
+    }
 
-    // Calcula a soma e conta zeros
-    // A cláusula reduction foi escolhida, pois cria uma instância
-    // local da variável para cada thread, e cada thread realiza
-    // a operação de soma sobre sua própria instância.
-    // Ao final, os resultados de todas as threads são combinados.
-    // Isso evita condições de corrida.
-    // explicação página 53 do PDF: IPPD-Aula8-OpenMP - IPPD-Aula8-OpenMP
-
-    #pragma omp parallel for reduction(+:sum, zero_count)
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            printf("Thread %d está processando a iteração %d-%d - valor: %d\n", omp_get_thread_num(), i, j, a[i][j]);
-            sum += a[i][j];
-            if (a[i][j] == 0) {
-                zero_count++;
+    // Trace opcional: cada thread anota em memória e tudo é gravado no fim,
+    // fora da região medida
+    TraceBuffer *trace = NULL;
+    if (trace_file != NULL) {
+        trace = (TraceBuffer *)aligned_alloc(TRACE_CACHE_LINE, threads * sizeof(TraceBuffer));
+        if (trace == NULL) {
+            fprintf(stderr, "Error allocating trace buffers\n");
+            return 1;
+        }
+        memset(trace, 0, threads * sizeof(TraceBuffer));
+        for (int t = 0; t < threads; t++) {
+            trace[t].events = (TraceEvent *)malloc(n * sizeof(TraceEvent));
+            if (trace[t].events == NULL) {
+                fprintf(stderr, "Error allocating trace for %d rows\n", n);
+                return 1;
             }
         }
     }
 
-    // Calcula a média
-    media = (float)sum / (N * N);
-    printf("A Media:: %f\n", media);
-
-    // Calcula a soma das variâncias
-    // variância é o (valor menos a média)tudo elevado a 2
-    // a variância não foi aplicada antes, pois havia
-    // a necessidade de ter o valor da media
-
-    #pragma omp parallel for reduction(+:variance_sum)
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            variance_sum += (a[i][j] - media)*(a[i][j] - media);
+    // Inicializa a matriz em paralelo: com Philox cada elemento depende só do
+    // seu índice e da semente, então cada thread gera as suas linhas sem
+    // disputar o estado global do rand() e a matriz não muda com o número de
+    // threads. O mesmo escalonamento estático do laço de análise faz cada
+    // thread tocar primeiro (first touch) as páginas que vai ler depois
+    double t0 = omp_get_wtime();
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        philox_fill_ints(a + (size_t)i * n, (uint64_t)i * n, n, SEED, 0, 99); // Gera números entre 0 e 99
+    }
+    double t1 = omp_get_wtime();
+
+    // Passe único sobre a matriz: contagem, zeros, média e M2 (Welford/Chan)
+    // de cada linha são combinados por thread e depois entre threads pela
+    // redução declarada acima. Nenhuma E/S dentro do laço: o printf por
+    // elemento serializava as threads no lock do stdio
+    RunningStats stats;
+    running_stats_init(&stats);
+    #pragma omp parallel for schedule(static) reduction(merge : stats)
+    for (int i = 0; i < n; i++) {
+        double row_start = trace != NULL ? omp_get_wtime() : 0.0;
+        stats_reduce_i32(&stats, a + (size_t)i * n, n);
+        if (trace != NULL) {
+            TraceBuffer *buf = &trace[omp_get_thread_num()];
+            buf->events[buf->count++] = (TraceEvent){omp_get_thread_num(), i, row_start - t1, omp_get_wtime() - t1};
         }
     }
+    double t2 = omp_get_wtime();
 
-    // Calcula o desvio padrão
-    desvio_p = sqrt(variance_sum / (N * N));
-    printf("O desvio padrao: %f\n", desvio_p);
+    double media = stats.mean;
+    double desvio_p = sqrt(running_stats_variance(&stats));
+    double esparsividade = (double)stats.zeros / elements;
 
-    // Calcula a esparsidade
-    float esparsividade = (float)zero_count / (N * N);
-    printf("A matriz tem %d zeros de %d elementos.\n", zero_count, N * N);
+    printf("A Media:: %f\n", media);
+    printf("O desvio padrao: %f\n", desvio_p);
+    printf("A matriz tem %lld zeros de %zu elementos.\n", stats.zeros, elements);
     printf("esparsividade: %f\n", esparsividade);
 
     // se houver mais do que 50% 0's ela esparsa
@@ -83,5 +150,30 @@ int main() {
         printf("A matriz não é esparsa.\n");
     }
 
+    double analysis = t2 - t1;
+    printf("Threads: %d\n", threads);
+    printf("Tempo de geração: %.6f s\n", t1 - t0);
+    printf("Tempo de análise: %.6f s (%.2f GFLOP/s, %.2f GB/s)\n", analysis,
+           FLOPS_PER_ELEMENT * (double)elements / analysis / 1e9,
+           elements * sizeof(int) / analysis / 1e9);
+
+    if (trace != NULL) {
+        FILE *out = fopen(trace_file, "w");
+        if (out == NULL) {
+            perror(trace_file);
+        } else {
+            setvbuf(out, NULL, _IOFBF, 1 << 20);
+            fprintf(out, "# thread linha inicio_s fim_s\n");
+            for (int t = 0; t < threads; t++)
+                for (int k = 0; k < trace[t].count; k++)
+                    fprintf(out, "%d %d %.9f %.9f\n", trace[t].events[k].thread, trace[t].events[k].row,
+                            trace[t].events[k].start, trace[t].events[k].end);
+            fclose(out);
+        }
+        for (int t = 0; t < threads; t++) free(trace[t].events);
+        free(trace);
+    }
+
+    free(a);
     return 0;
 }
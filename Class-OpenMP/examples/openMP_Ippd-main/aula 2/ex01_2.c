@@ -5,7 +5,7 @@
 int fib(int n){
     int r1, r2;
     if (n < 2) return n;
-    #pragma omp task shared(r1)
+    #pragma omp task shared(r2)
         r2 = fib(n - 2);
     r1 = fib(n - 1);
     #pragma omp taskwait
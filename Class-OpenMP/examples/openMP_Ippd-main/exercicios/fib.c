@@ -2,21 +2,34 @@
 #include <stdlib.h>
 #include <omp.h>
 
+// Abaixo deste n a recursão segue sem criar tarefas: fib(20) já tem ~20 mil
+// chamadas, trabalho suficiente para pagar o custo de uma tarefa. Sem o
+// corte, cada chamada vira duas tarefas e mais threads deixam fib(30) mais
+// lento que o serial (ver fib_bench.cpp, que varre corte e threads)
+#define CUTOFF 20
+
+int fib_serial(int n){
+    if (n < 2) return n;
+    return fib_serial(n - 1) + fib_serial(n - 2);
+}
+
 // Algoritmos Recursivos
 // task/taskwait
 int fib(int n){
     int r1, r2;
-    if (n < 2) return n;
-    #pragma omp task shared(r1)
+    if (n <= CUTOFF) return fib_serial(n);
+    // final: abaixo do corte a tarefa é executada na hora por quem a cria;
+    // mergeable: ela pode usar o ambiente de dados de quem a criou
+    #pragma omp task shared(r1) final(n - 1 <= CUTOFF) mergeable
     r1 = fib(n - 1);
-    #pragma omp task shared(r2)
+    // O segundo filho roda nesta própria tarefa
     r2 = fib(n - 2);
     #pragma omp taskwait
     return r1 + r2;
 }
 
-int main() {
-    int r, n=10;
+int main(int argc, char *argv[]) {
+    int r, n = argc > 1 ? atoi(argv[1]) : 30;
     
     #pragma omp parallel
     {
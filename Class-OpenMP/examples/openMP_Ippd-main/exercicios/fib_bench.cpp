@@ -0,0 +1,137 @@
+// fib(n) com tarefas OpenMP: varredura do corte serial e do número de
+// threads, usando o framework de divisão e conquista de common/task_dc.hpp.
+//
+// O fib.c cria duas tarefas em todo nível da recursão; em fib(30) isso são
+// milhões de tarefas com poucos nanossegundos de trabalho cada e mais threads
+// deixam o programa mais lento que o serial. Aqui o corte (-c) define até
+// onde a recursão vira tarefa; corte 0 é o comportamento do fib.c.
+//
+// Comando para gerar o executável:
+// g++ -O2 -fopenmp -I../../../../common fib_bench.cpp -o fib_bench
+//
+// Comando para executar
+// ./fib_bench                              (fib(30), cortes 0,5,10,15,20,25, threads 1,2,4)
+// ./fib_bench -n 35 -c 10,20,25 -T 8 -r 5
+// ./fib_bench -n 40 -c 25 -d 12            (profundidade máxima de 12 níveis de tarefas)
+
+#include <omp.h>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "task_dc.hpp"
+
+struct Fib {
+    using Input = int;
+    using Result = long long;
+    static constexpr long long base = 1;
+
+    long long size(int n) const { return n; }
+    // A mesma recursão do fib.c, sem diretivas: o trabalho de cada folha
+    Result serial(int n) const { return n < 2 ? n : serial(n - 1) + serial(n - 2); }
+    std::pair<int, int> split(int n) const { return {n - 1, n - 2}; }
+    Result combine(Result a, Result b) const { return a + b; }
+};
+
+// Caminho iterativo: O(n) em vez de O(fib(n)), sem paralelismo nenhum. É o
+// que se usa de fato para calcular fib; a versão recursiva fica como carga
+// de trabalho de tarefas
+static long long fib_iterative(int n) {
+    long long a = 0, b = 1;
+    for (int i = 0; i < n; i++) {
+        long long next = a + b;
+        a = b;
+        b = next;
+    }
+    return a;
+}
+
+// Diretivas task para um dado corte e profundidade, iguais nos dois modos:
+// uma por nó interno acima do corte (o segundo filho roda na própria
+// tarefa). No modo corte todas são adiáveis; no modo final as que criam um
+// filho abaixo do corte são finais, executadas na hora por quem as cria
+static long long count_tasks(int n, long long cutoff, int max_depth, int depth) {
+    if (n <= Fib::base || n <= cutoff || (max_depth >= 0 && depth >= max_depth)) return 0;
+    return 1 + count_tasks(n - 1, cutoff, max_depth, depth + 1) + count_tasks(n - 2, cutoff, max_depth, depth + 1);
+}
+
+// Melhor tempo de `reps` execuções de `op`
+template <class Op>
+double best_time(int reps, Op op) {
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        double start = omp_get_wtime();
+        op();
+        double elapsed = omp_get_wtime() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int n = 30, max_threads = 4, max_depth = -1, reps = 3, opt;
+    const char *cutoffs = "0,5,10,15,20,25";
+    while ((opt = getopt(argc, argv, "n:c:T:d:r:")) != -1) {
+        switch (opt) {
+        case 'n': n = std::atoi(optarg); break;
+        case 'c': cutoffs = optarg; break;
+        case 'T': max_threads = std::atoi(optarg); break;
+        case 'd': max_depth = std::atoi(optarg); break;
+        case 'r': reps = std::atoi(optarg); break;
+        default:
+            std::fprintf(stderr, "Usage: %s [-n N] [-c cutoff,cutoff,...] [-T max_threads] [-d max_depth] [-r reps]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    if (n < 0 || n > 92 || max_threads <= 0 || reps <= 0) { // fib(93) não cabe em long long
+        std::fprintf(stderr, "Invalid N (0..92), thread count or repetition count\n");
+        return 1;
+    }
+
+    std::vector<long long> cuts;
+    for (const char *c = cutoffs; *c != '\0';) {
+        char *end;
+        cuts.push_back(std::strtoll(c, &end, 10));
+        if (end == c) {
+            std::fprintf(stderr, "Invalid cutoff list: %s\n", cutoffs);
+            return 1;
+        }
+        c = *end == ',' ? end + 1 : end;
+    }
+
+    Fib fib;
+    long long expected = fib_iterative(n);
+    double iterative = best_time(reps, [&] {
+        volatile long long r = fib_iterative(n);
+        (void)r;
+    });
+    long long serial_result = 0;
+    double serial = best_time(reps, [&] { serial_result = fib.serial(n); });
+    std::printf("fib(%d) = %lld\n", n, expected);
+    std::printf("iterativo: %.6f ms; recursivo serial: %.3f ms%s\n", iterative * 1e3, serial * 1e3,
+                serial_result == expected ? "" : "  ERRO");
+    std::printf("%-7s %6s %7s %12s %12s %9s\n", "modo", "corte", "threads", "tarefas", "tempo (ms)", "speedup");
+
+    int failed = serial_result != expected;
+    for (int m = 0; m < 2; m++) {
+        dc::Mode mode = m == 0 ? dc::CUTOFF : dc::FINAL;
+        for (long long cut : cuts) {
+            long long tasks = count_tasks(n, cut, max_depth, 0);
+            for (int t = 1; t <= max_threads; t *= 2) {
+                dc::Options o;
+                o.cutoff = cut;
+                o.max_depth = max_depth;
+                o.mode = mode;
+                o.threads = t;
+                long long r = 0;
+                double elapsed = best_time(reps, [&] { r = dc::solve(fib, n, o); });
+                failed |= r != expected;
+                std::printf("%-7s %6lld %7d %12lld %12.3f %9.2f%s\n", mode == dc::CUTOFF ? "corte" : "final", cut, t,
+                            tasks, elapsed * 1e3, serial / elapsed, r == expected ? "" : "  ERRO");
+            }
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,244 @@
+// Tarefas OpenMP x escalonador próprio com roubo de trabalho
+// (common/work_stealing.hpp) em três recursões de granularidade fina: fib,
+// soma de uma árvore binária e quicksort.
+//
+// As três versões de cada carga têm a mesma estrutura: o primeiro filho vira
+// tarefa, o segundo continua na tarefa atual e abaixo do grão (-g) a
+// recursão é serial. Só muda quem cria e escalona as tarefas.
+//
+// Comando para gerar o executável:
+// g++ -O2 -std=c++17 -fopenmp -pthread -I../../../../common ws_bench.cpp -o ws_bench
+//
+// Comando para executar
+// ./ws_bench                       (4 threads, grão padrão de cada carga)
+// ./ws_bench -t 8 -n 35 -r 5
+// ./ws_bench -g 1                  (grão mínimo: uma tarefa por nó, o pior caso para o runtime OpenMP)
+// OMP_WAIT_POLICY=passive ./ws_bench   (threads OpenMP ociosas não disputam a CPU com os workers)
+
+#include <omp.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <unistd.h>
+#include "work_stealing.hpp"
+
+// ---------------------------------------------------------------- fib
+
+static long long fib_serial(int n) { return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2); }
+
+static long long fib_omp(int n, int grain) {
+    if (n <= grain || n < 2) return fib_serial(n);
+    long long a, b;
+    #pragma omp task shared(a)
+    a = fib_omp(n - 1, grain);
+    b = fib_omp(n - 2, grain);
+    #pragma omp taskwait
+    return a + b;
+}
+
+static long long fib_ws(int n, int grain) {
+    if (n <= grain || n < 2) return fib_serial(n);
+    long long a, b;
+    ws::TaskGroup g;
+    g.spawn([&] { a = fib_ws(n - 1, grain); });
+    b = fib_ws(n - 2, grain);
+    g.sync();
+    return a + b;
+}
+
+// ---------------------------------------------------------------- árvore
+
+struct Node {
+    long long value;
+    long long size; // nós na subárvore
+    Node *left, *right;
+};
+
+// Árvore de [lo, hi) com raiz em posição pseudoaleatória: desbalanceada,
+// como uma árvore de busca com inserções aleatórias. Os nós ficam no vetor
+// em pré-ordem
+static Node *build_tree(std::vector<Node> &pool, long long lo, long long hi, std::uint64_t &state) {
+    if (lo >= hi) return nullptr;
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    long long root = lo + (long long)((state >> 33) % (std::uint64_t)(hi - lo));
+    Node *node = &pool.emplace_back();
+    node->value = root;
+    node->size = hi - lo;
+    node->left = build_tree(pool, lo, root, state);
+    node->right = build_tree(pool, root + 1, hi, state);
+    return node;
+}
+
+static long long tree_serial(const Node *node) {
+    return node == nullptr ? 0 : node->value + tree_serial(node->left) + tree_serial(node->right);
+}
+
+static long long tree_omp(const Node *node, long long grain) {
+    if (node == nullptr || node->size <= grain) return tree_serial(node);
+    long long a, b;
+    #pragma omp task shared(a)
+    a = tree_omp(node->left, grain);
+    b = tree_omp(node->right, grain);
+    #pragma omp taskwait
+    return node->value + a + b;
+}
+
+static long long tree_ws(const Node *node, long long grain) {
+    if (node == nullptr || node->size <= grain) return tree_serial(node);
+    long long a, b;
+    ws::TaskGroup g;
+    g.spawn([&] { a = tree_ws(node->left, grain); });
+    b = tree_ws(node->right, grain);
+    g.sync();
+    return node->value + a + b;
+}
+
+// ---------------------------------------------------------------- quicksort
+
+// Partição de Hoare com mediana de três; devolve j tal que [lo, j] <= [j+1, hi]
+static long long partition(int *v, long long lo, long long hi) {
+    long long mid = lo + (hi - lo) / 2;
+    if (v[mid] < v[lo]) std::swap(v[mid], v[lo]);
+    if (v[hi] < v[lo]) std::swap(v[hi], v[lo]);
+    if (v[hi] < v[mid]) std::swap(v[hi], v[mid]);
+    int pivot = v[mid];
+    long long i = lo - 1, j = hi + 1;
+    for (;;) {
+        do i++; while (v[i] < pivot);
+        do j--; while (v[j] > pivot);
+        if (i >= j) return j;
+        std::swap(v[i], v[j]);
+    }
+}
+
+static void sort_serial(int *v, long long lo, long long hi) { std::sort(v + lo, v + hi + 1); }
+
+static void sort_omp(int *v, long long lo, long long hi, long long grain) {
+    if (hi - lo + 1 <= grain) return sort_serial(v, lo, hi);
+    long long p = partition(v, lo, hi);
+    #pragma omp task
+    sort_omp(v, lo, p, grain);
+    sort_omp(v, p + 1, hi, grain);
+    #pragma omp taskwait
+}
+
+static void sort_ws(int *v, long long lo, long long hi, long long grain) {
+    if (hi - lo + 1 <= grain) return sort_serial(v, lo, hi);
+    long long p = partition(v, lo, hi);
+    ws::TaskGroup g;
+    g.spawn([=] { sort_ws(v, lo, p, grain); });
+    sort_ws(v, p + 1, hi, grain);
+    g.sync();
+}
+
+// ---------------------------------------------------------------- medição
+
+// Melhor tempo de `reps` execuções de `op`; `prepare` roda antes de cada uma
+// fora da medida
+template <class Prepare, class Op>
+double best_time(int reps, Prepare prepare, Op op) {
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        prepare();
+        double start = omp_get_wtime();
+        op();
+        double elapsed = omp_get_wtime() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+static void report(const char *name, double serial, double omp, double ws, bool ok) {
+    std::printf("%-10s %12.3f %12.3f %12.3f %12.2f %12.2f %10.2f%s\n", name, serial * 1e3, omp * 1e3, ws * 1e3,
+                serial / omp, serial / ws, omp / ws, ok ? "" : "  ERRO");
+}
+
+int main(int argc, char *argv[]) {
+    int threads = 4, n = 30, reps = 3, opt;
+    long long grain = -1; // -1 = padrão de cada carga
+    long long tree_nodes = 1 << 21, sort_n = 1 << 22;
+    while ((opt = getopt(argc, argv, "t:n:g:m:s:r:")) != -1) {
+        switch (opt) {
+        case 't': threads = std::atoi(optarg); break;
+        case 'n': n = std::atoi(optarg); break;
+        case 'g': grain = std::atoll(optarg); break;
+        case 'm': tree_nodes = (long long)std::strtod(optarg, NULL); break;
+        case 's': sort_n = (long long)std::strtod(optarg, NULL); break;
+        case 'r': reps = std::atoi(optarg); break;
+        default:
+            std::fprintf(stderr, "Usage: %s [-t threads] [-n fib_n] [-g grain] [-m tree_nodes] [-s sort_n] [-r reps]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    if (threads <= 0 || n < 0 || n > 92 || tree_nodes <= 0 || sort_n <= 0 || reps <= 0) {
+        std::fprintf(stderr, "Invalid thread count, N, size or repetition count\n");
+        return 1;
+    }
+    // Grãos padrão: fib(10) e 256 nós já são só algumas centenas de ns de
+    // trabalho por tarefa; o quicksort usa std::sort abaixo de 2048
+    int fib_grain = grain >= 0 ? (int)grain : 10;
+    long long tree_grain = grain >= 0 ? grain : 256, sort_grain = grain >= 0 ? std::max(grain, 2LL) : 2048;
+
+    ws::Scheduler sched(threads);
+    std::printf("%d threads, melhor de %d\n", threads, reps);
+    std::printf("%-10s %12s %12s %12s %12s %12s %10s\n", "carga", "serial (ms)", "omp (ms)", "ws (ms)",
+                "speedup omp", "speedup ws", "omp/ws");
+    bool failed = false;
+    auto nothing = [] {};
+
+    long long expected = fib_serial(n), r_omp = 0, r_ws = 0;
+    double t_serial = best_time(reps, nothing, [&] { expected = fib_serial(n); });
+    double t_omp = best_time(reps, nothing, [&] {
+        #pragma omp parallel num_threads(threads)
+        #pragma omp single
+        r_omp = fib_omp(n, fib_grain);
+    });
+    double t_ws = best_time(reps, nothing, [&] { r_ws = sched.run([&] { return fib_ws(n, fib_grain); }); });
+    bool ok = r_omp == expected && r_ws == expected;
+    failed |= !ok;
+    report("fib", t_serial, t_omp, t_ws, ok);
+
+    std::vector<Node> pool;
+    pool.reserve(tree_nodes); // ponteiros estáveis durante a construção
+    std::uint64_t state = 2024;
+    const Node *root = build_tree(pool, 0, tree_nodes, state);
+    expected = tree_nodes * (tree_nodes - 1) / 2; // valores 0..m-1
+    long long r_serial = 0;
+    t_serial = best_time(reps, nothing, [&] { r_serial = tree_serial(root); });
+    t_omp = best_time(reps, nothing, [&] {
+        #pragma omp parallel num_threads(threads)
+        #pragma omp single
+        r_omp = tree_omp(root, tree_grain);
+    });
+    t_ws = best_time(reps, nothing, [&] { r_ws = sched.run([&] { return tree_ws(root, tree_grain); }); });
+    ok = r_serial == expected && r_omp == expected && r_ws == expected;
+    failed |= !ok;
+    report("árvore", t_serial, t_omp, t_ws, ok);
+
+    // Mesmos dados desordenados antes de cada execução
+    std::vector<int> input(sort_n), v(sort_n);
+    state = 2024;
+    for (int &x : input) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        x = (int)(state >> 33);
+    }
+    auto reset = [&] { std::copy(input.begin(), input.end(), v.begin()); };
+    std::vector<int> sorted(input);
+    std::sort(sorted.begin(), sorted.end());
+    t_serial = best_time(reps, reset, [&] { sort_serial(v.data(), 0, sort_n - 1); });
+    t_omp = best_time(reps, reset, [&] {
+        #pragma omp parallel num_threads(threads)
+        #pragma omp single
+        sort_omp(v.data(), 0, sort_n - 1, sort_grain);
+    });
+    ok = v == sorted;
+    t_ws = best_time(reps, reset, [&] { sched.run([&] { sort_ws(v.data(), 0, sort_n - 1, sort_grain); }); });
+    ok = ok && v == sorted;
+    failed |= !ok;
+    report("quicksort", t_serial, t_omp, t_ws, ok);
+
+    return failed;
+}
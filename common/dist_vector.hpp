@@ -0,0 +1,222 @@
+#ifndef DIST_VECTOR_HPP
+#define DIST_VECTOR_HPP
+
+/**
+ * Vetor distribuído por blocos entre os ranks de um comunicador, com
+ * expressões elemento a elemento fundidas (expression templates).
+ *
+ *     dist::Vector<double> A(MPI_COMM_WORLD, n), B(...), C(...), D(...);
+ *     A.generate([](long long i) { return ...; }); // cada rank gera o seu bloco
+ *     C = a * A + B * D;                            // um único passe, sem temporários
+ *     double s = dist::sum(C);                      // redução local + MPI_Allreduce
+ *     std::vector<double> all = C.gather(0);        // só quando pedido
+ *
+ * Cada rank é dono de um bloco contíguo de índices globais (divisão
+ * desigual: os primeiros n % size ranks ficam com um elemento a mais) e os
+ * dados nascem e ficam nele: não há Scatter na criação nem Gather depois de
+ * cada operação. Os operadores +, -, * e / (entre vetores, expressões e
+ * escalares) só montam a árvore da expressão; o laço acontece na atribuição,
+ * com `omp parallel for simd` sobre o bloco local, então `C = a*A + B*D` lê
+ * A, B e D uma vez e escreve C uma vez.
+ *
+ * O armazenamento é alinhado a 64 bytes e não é inicializado na alocação: o
+ * primeiro toque (generate ou atribuição, com o mesmo escalonamento
+ * estático) põe cada página no nó NUMA da thread que vai usá-la.
+ *
+ * Incluir depois de <mpi.h>. Header-only: basta incluir (compilar com
+ * -I<raiz>/common).
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dist {
+
+template <class T> MPI_Datatype mpi_type();
+template <> inline MPI_Datatype mpi_type<int>() { return MPI_INT; }
+template <> inline MPI_Datatype mpi_type<long long>() { return MPI_LONG_LONG; }
+template <> inline MPI_Datatype mpi_type<float>() { return MPI_FLOAT; }
+template <> inline MPI_Datatype mpi_type<double>() { return MPI_DOUBLE; }
+
+// Base CRTP de todas as expressões: E fornece operator[](índice local) e
+// size() (tamanho global, ou -1 para escalares)
+template <class E>
+struct Expr {
+    const E &self() const { return static_cast<const E &>(*this); }
+};
+
+template <class T> class Vector;
+
+// Vetores entram nas expressões por referência; o resto (escalares e nós
+// intermediários, que são pequenos) por valor, para que uma expressão
+// guardada em `auto` continue válida
+template <class E> struct Stored { using type = E; };
+template <class T> struct Stored<Vector<T>> { using type = const Vector<T> &; };
+
+template <class T>
+struct Scalar : Expr<Scalar<T>> {
+    T value;
+    explicit Scalar(T v) : value(v) {}
+    T operator[](long long) const { return value; }
+    long long size() const { return -1; }
+};
+
+template <class L, class R, class Op>
+struct Binary : Expr<Binary<L, R, Op>> {
+    typename Stored<L>::type l;
+    typename Stored<R>::type r;
+
+    Binary(const L &left, const R &right) : l(left), r(right) {
+        assert(l.size() < 0 || r.size() < 0 || l.size() == r.size());
+    }
+    auto operator[](long long i) const { return Op::apply(l[i], r[i]); }
+    long long size() const { return l.size() >= 0 ? l.size() : r.size(); }
+};
+
+struct Add { template <class A, class B> static auto apply(A a, B b) { return a + b; } };
+struct Sub { template <class A, class B> static auto apply(A a, B b) { return a - b; } };
+struct Mul { template <class A, class B> static auto apply(A a, B b) { return a * b; } };
+struct Div { template <class A, class B> static auto apply(A a, B b) { return a / b; } };
+
+// Operadores entre expressões e entre expressão e escalar
+#define DIST_VECTOR_OPERATOR(op, Op)                                                                      \
+    template <class L, class R>                                                                          \
+    Binary<L, R, Op> operator op(const Expr<L> &l, const Expr<R> &r) {                                   \
+        return Binary<L, R, Op>(l.self(), r.self());                                                     \
+    }                                                                                                    \
+    template <class L, class S, class = typename std::enable_if<std::is_arithmetic<S>::value>::type>    \
+    Binary<L, Scalar<S>, Op> operator op(const Expr<L> &l, S s) {                                        \
+        return Binary<L, Scalar<S>, Op>(l.self(), Scalar<S>(s));                                         \
+    }                                                                                                    \
+    template <class S, class R, class = typename std::enable_if<std::is_arithmetic<S>::value>::type>    \
+    Binary<Scalar<S>, R, Op> operator op(S s, const Expr<R> &r) {                                        \
+        return Binary<Scalar<S>, R, Op>(Scalar<S>(s), r.self());                                         \
+    }
+
+DIST_VECTOR_OPERATOR(+, Add)
+DIST_VECTOR_OPERATOR(-, Sub)
+DIST_VECTOR_OPERATOR(*, Mul)
+DIST_VECTOR_OPERATOR(/, Div)
+
+#undef DIST_VECTOR_OPERATOR
+
+template <class T>
+class Vector : public Expr<Vector<T>> {
+public:
+    Vector(MPI_Comm comm, long long n) : comm_(comm), n_(n) {
+        int rank, size;
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &size);
+        long long base = n / size, extra = n % size;
+        first_ = rank * base + (rank < extra ? rank : extra);
+        local_n_ = base + (rank < extra ? 1 : 0);
+        // Sem inicializar: o primeiro toque fica com quem gera ou atribui
+        std::size_t bytes = (static_cast<std::size_t>(local_n_) * sizeof(T) + 63) / 64 * 64;
+        data_ = static_cast<T *>(std::aligned_alloc(64, bytes > 0 ? bytes : 64));
+        if (data_ == nullptr) throw std::bad_alloc();
+    }
+    ~Vector() { std::free(data_); }
+
+    Vector(const Vector &) = delete;
+    Vector &operator=(const Vector &) = delete;
+    Vector(Vector &&o) noexcept
+        : comm_(o.comm_), n_(o.n_), first_(o.first_), local_n_(o.local_n_), data_(o.data_) {
+        o.data_ = nullptr;
+    }
+
+    // Avalia a expressão inteira num único laço sobre o bloco local
+    template <class E>
+    Vector &operator=(const Expr<E> &expr) {
+        const E &e = expr.self();
+        assert(e.size() < 0 || e.size() == n_);
+        T *out = data_;
+        const long long m = local_n_;
+        #pragma omp parallel for simd schedule(static)
+        for (long long i = 0; i < m; i++) out[i] = static_cast<T>(e[i]);
+        return *this;
+    }
+    Vector &operator=(T value) { return *this = Scalar<T>(value); }
+
+    // Preenche o bloco local com g(índice global)
+    template <class Gen>
+    void generate(Gen g) {
+        T *out = data_;
+        const long long m = local_n_, first = first_;
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < m; i++) out[i] = static_cast<T>(g(first + i));
+    }
+
+    // Junta o vetor inteiro em `root` (vazio nos outros ranks)
+    std::vector<T> gather(int root) const {
+        int rank, size;
+        MPI_Comm_rank(comm_, &rank);
+        MPI_Comm_size(comm_, &size);
+        std::vector<int> counts(size), displs(size);
+        int count = static_cast<int>(local_n_);
+        MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, root, comm_);
+        std::vector<T> all;
+        if (rank == root) {
+            for (int r = 1; r < size; r++) displs[r] = displs[r - 1] + counts[r - 1];
+            all.resize(n_);
+        }
+        MPI_Gatherv(data_, count, mpi_type<T>(), all.data(), counts.data(), displs.data(), mpi_type<T>(), root,
+                    comm_);
+        return all;
+    }
+
+    T operator[](long long i) const { return data_[i]; } // índice local
+    T &operator[](long long i) { return data_[i]; }
+    long long size() const { return n_; }
+    long long local_size() const { return local_n_; }
+    long long first() const { return first_; } // índice global do primeiro elemento local
+    T *data() { return data_; }
+    const T *data() const { return data_; }
+    MPI_Comm comm() const { return comm_; }
+
+private:
+    MPI_Comm comm_;
+    long long n_, first_, local_n_;
+    T *data_;
+};
+
+// Comunicador de uma expressão: o do primeiro vetor encontrado
+template <class T> MPI_Comm comm_of(const Vector<T> &v) { return v.comm(); }
+template <class T> MPI_Comm comm_of(const Scalar<T> &) { return MPI_COMM_NULL; }
+template <class L, class R, class Op> MPI_Comm comm_of(const Binary<L, R, Op> &b) {
+    MPI_Comm c = comm_of(b.l);
+    return c != MPI_COMM_NULL ? c : comm_of(b.r);
+}
+
+// Soma global da expressão, fundida: nada é materializado. Inteiros somam
+// em long long, reais em double
+template <class E>
+auto sum(const Expr<E> &expr) {
+    const E &e = expr.self();
+    using V = decltype(e[0]);
+    using S = typename std::conditional<std::is_integral<V>::value, long long, double>::type;
+    MPI_Comm comm = comm_of(e);
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    long long n = e.size(), base = n / size, extra = n % size;
+    const long long m = base + (rank < extra ? 1 : 0);
+    S local = 0;
+    #pragma omp parallel for simd schedule(static) reduction(+ : local)
+    for (long long i = 0; i < m; i++) local += static_cast<S>(e[i]);
+    S global = 0;
+    MPI_Allreduce(&local, &global, 1, mpi_type<S>(), MPI_SUM, comm);
+    return global;
+}
+
+template <class L, class R>
+auto dot(const Expr<L> &a, const Expr<R> &b) { return sum(a * b); }
+
+} // namespace dist
+
+#endif // DIST_VECTOR_HPP
@@ -0,0 +1,223 @@
+#ifndef DOT_KERNELS_H
+#define DOT_KERNELS_H
+
+/**
+ * Produto escalar e produto matriz-vetor (GEMV) em double, com OpenMP e
+ * SIMD.
+ *
+ *     double d = dot(DOT_FAST, a, b, n);          // a·b, todas as threads
+ *     gemv(DOT_FAST, A, x, y, m, n);              // y = A x, A m x n por linhas
+ *
+ * Modos:
+ *
+ *     DOT_FAST      DOT_LANES acumuladores independentes com FMA: vários
+ *                   registros SIMD em paralelo, para não esperar a latência
+ *                   de cada FMA. Erro relativo ~ n * u * condição.
+ *     DOT_KAHAN     soma compensada (Kahan, na forma Dot2 de Ogita, Rump e
+ *                   Oishi): o erro de cada produto sai exato de um FMA (ou
+ *                   da divisão de Dekker, sem FMA) e o de cada soma de um
+ *                   TwoSum; os erros são acumulados à
+ *                   parte. Resultado como se calculado com o dobro da
+ *                   precisão; ~3x mais operações.
+ *     DOT_PAIRWISE  blocos de DOT_PAIRWISE_BLOCK com o kernel rápido,
+ *                   somados em árvore: erro ~ log2(n) * u * condição, quase
+ *                   sem custo extra.
+ *
+ * Paralelismo: o vetor é dividido em faixas contíguas, uma por thread,
+ * alinhadas a DOT_LANES elementos (dot_split). Quem inicializa os dados deve
+ * usar a mesma divisão (primeiro toque), para que em NUMA cada thread leia
+ * da memória do seu nó. Cada thread acumula em registradores e grava o
+ * parcial num DotPartial do tamanho de uma linha de cache: nenhuma thread
+ * escreve na linha de outra. Os parciais são somados em ordem de thread, então
+ * o resultado é o mesmo em toda execução com o mesmo número de threads.
+ *
+ * Compilar com -O3 -march=native -fopenmp (o FMA vem de -march=native; sem
+ * ele o modo rápido usa multiplicação e soma separadas e o compensado usa a
+ * divisão de Dekker, mais lenta porém igualmente exata) e sem -ffast-math,
+ * que desfaz a compensação do modo DOT_KAHAN. Ligar com -lm. Header-only: basta incluir
+ * (compilar com -I<raiz>/common).
+ */
+
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define DOT_LANES 32               // acumuladores do kernel rápido (4 vetores AVX-512, 8 AVX2)
+#define DOT_KAHAN_LANES 8          // acumuladores (soma + erro) do kernel compensado
+#define DOT_PAIRWISE_BLOCK 256     // folhas da árvore do modo DOT_PAIRWISE
+#define DOT_MAX_THREADS 256
+#define DOT_CACHE_LINE 64
+#define DOT_GEMV_ROWS 8            // linhas de y por unidade de divisão (64 bytes)
+
+typedef enum { DOT_FAST, DOT_KAHAN, DOT_PAIRWISE } DotMode;
+
+// Parcial de uma thread, sozinho na sua linha de cache
+typedef struct {
+    _Alignas(DOT_CACHE_LINE) double sum;
+    double err; // só DOT_KAHAN
+} DotPartial;
+
+// a * b + c para a acumulação do modo rápido: um arredondamento (vfmadd)
+// com -march=native; sem FMA, multiplicação e soma comuns
+#ifdef __FMA__
+#define DOT_FMA(a, b, c) fma(a, b, c)
+#else
+#define DOT_FMA(a, b, c) ((a) * (b) + (c))
+#endif
+
+#define DOT_SPLITTER 134217729.0 // 2^27 + 1: divide um double em duas metades de 26 bits
+
+// Erro exato do produto a * b = p (TwoProduct): a * b - p. Com FMA é uma
+// instrução; sem FMA, o algoritmo de Dekker (a e b divididos em metades cujos
+// produtos são exatos), ~17 operações mas ainda vetorizável
+static inline double dot_two_prod_err(double a, double b, double p) {
+#ifdef __FMA__
+    return fma(a, b, -p);
+#else
+    double ca = DOT_SPLITTER * a, cb = DOT_SPLITTER * b;
+    double a_hi = ca - (ca - a), a_lo = a - a_hi;
+    double b_hi = cb - (cb - b), b_lo = b - b_hi;
+    return ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+#endif
+}
+
+// Faixa [lo, hi) da thread t de nt em n itens, em múltiplos de `granule`
+// (a última thread fica com o resto)
+static inline void dot_split(long long n, long long granule, int t, int nt, long long *lo, long long *hi) {
+    long long units = (n + granule - 1) / granule;
+    *lo = units * t / nt * granule;
+    *hi = t == nt - 1 ? n : units * (t + 1) / nt * granule;
+    if (*lo > n) *lo = n;
+    if (*hi > n) *hi = n;
+}
+
+// Kernel rápido, serial: DOT_LANES somas parciais vetorizadas
+static inline double dot_fast_range(const double *a, const double *b, long long n) {
+    double acc[DOT_LANES] = {0.0};
+    long long i = 0;
+    for (; i + DOT_LANES <= n; i += DOT_LANES) {
+        #pragma omp simd
+        for (int l = 0; l < DOT_LANES; l++) acc[l] = DOT_FMA(a[i + l], b[i + l], acc[l]);
+    }
+    for (; i < n; i++) acc[0] = DOT_FMA(a[i], b[i], acc[0]);
+    // Redução das lanes em árvore
+    for (int w = DOT_LANES / 2; w > 0; w /= 2) {
+        for (int l = 0; l < w; l++) acc[l] += acc[l + w];
+    }
+    return acc[0];
+}
+
+// s + x = *sum + *err exatamente (TwoSum de Knuth): acumula em (sum, err)
+static inline void dot_two_sum(double *sum, double *err, double x) {
+    double t = *sum + x;
+    double z = t - *sum;
+    *err += (*sum - (t - z)) + (x - z);
+    *sum = t;
+}
+
+// Kernel compensado, serial (Dot2): devolve soma e erro acumulado
+static inline void dot_kahan_range(const double *a, const double *b, long long n, double *sum, double *err) {
+    double s[DOT_KAHAN_LANES] = {0.0}, c[DOT_KAHAN_LANES] = {0.0};
+    long long i = 0;
+    for (; i + DOT_KAHAN_LANES <= n; i += DOT_KAHAN_LANES) {
+        #pragma omp simd
+        for (int l = 0; l < DOT_KAHAN_LANES; l++) {
+            double p = a[i + l] * b[i + l];
+            double pe = dot_two_prod_err(a[i + l], b[i + l], p); // erro exato do produto
+            double t = s[l] + p;
+            double z = t - s[l];
+            c[l] += ((s[l] - (t - z)) + (p - z)) + pe;
+            s[l] = t;
+        }
+    }
+    for (; i < n; i++) {
+        double p = a[i] * b[i];
+        c[0] += dot_two_prod_err(a[i], b[i], p);
+        dot_two_sum(&s[0], &c[0], p);
+    }
+    double total = 0.0, error = 0.0;
+    for (int l = 0; l < DOT_KAHAN_LANES; l++) {
+        dot_two_sum(&total, &error, s[l]);
+        error += c[l];
+    }
+    *sum = total;
+    *err = error;
+}
+
+// Soma em árvore de blocos do kernel rápido (cortes em múltiplos de DOT_LANES)
+static inline double dot_pairwise_range(const double *a, const double *b, long long n) {
+    if (n <= DOT_PAIRWISE_BLOCK) return dot_fast_range(a, b, n);
+    long long half = n / 2 / DOT_LANES * DOT_LANES;
+    return dot_pairwise_range(a, b, half) + dot_pairwise_range(a + half, b + half, n - half);
+}
+
+// Produto escalar serial no modo pedido
+static inline double dot_range(DotMode mode, const double *a, const double *b, long long n) {
+    double sum, err;
+    switch (mode) {
+    case DOT_KAHAN:
+        dot_kahan_range(a, b, n, &sum, &err);
+        return sum + err;
+    case DOT_PAIRWISE: return dot_pairwise_range(a, b, n);
+    default: return dot_fast_range(a, b, n);
+    }
+}
+
+// a·b com todas as threads do OpenMP (até DOT_MAX_THREADS)
+static inline double dot(DotMode mode, const double *a, const double *b, long long n) {
+    DotPartial partials[DOT_MAX_THREADS];
+    int team = 1;
+#ifdef _OPENMP
+    team = omp_get_max_threads();
+    if (team > DOT_MAX_THREADS) team = DOT_MAX_THREADS;
+#endif
+    #pragma omp parallel num_threads(team)
+    {
+        int t = 0, nt = 1;
+#ifdef _OPENMP
+        t = omp_get_thread_num();
+        nt = omp_get_num_threads();
+#endif
+        long long lo, hi;
+        dot_split(n, DOT_LANES, t, nt, &lo, &hi);
+        if (mode == DOT_KAHAN) {
+            dot_kahan_range(a + lo, b + lo, hi - lo, &partials[t].sum, &partials[t].err);
+        } else {
+            partials[t].sum = dot_range(mode, a + lo, b + lo, hi - lo);
+            partials[t].err = 0.0;
+        }
+        #pragma omp single
+        team = nt; // o runtime pode dar menos threads que o pedido
+    }
+    // Em ordem de thread: determinístico; no modo DOT_KAHAN também compensado
+    double sum = 0.0, err = 0.0;
+    for (int t = 0; t < team; t++) {
+        if (mode == DOT_KAHAN) {
+            dot_two_sum(&sum, &err, partials[t].sum);
+            err += partials[t].err;
+        } else {
+            sum += partials[t].sum;
+        }
+    }
+    return sum + err;
+}
+
+// y = A x, com A de m linhas e n colunas guardada por linhas. As linhas são
+// divididas em faixas contíguas por thread (em múltiplos de DOT_GEMV_ROWS,
+// para que duas threads não escrevam na mesma linha de cache de y)
+static inline void gemv(DotMode mode, const double *A, const double *x, double *y, long long m, long long n) {
+    #pragma omp parallel
+    {
+        int t = 0, nt = 1;
+#ifdef _OPENMP
+        t = omp_get_thread_num();
+        nt = omp_get_num_threads();
+#endif
+        long long lo, hi;
+        dot_split(m, DOT_GEMV_ROWS, t, nt, &lo, &hi);
+        for (long long i = lo; i < hi; i++) y[i] = dot_range(mode, A + i * n, x, n);
+    }
+}
+
+#endif // DOT_KERNELS_H
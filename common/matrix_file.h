@@ -0,0 +1,210 @@
+#ifndef MATRIX_FILE_H
+#define MATRIX_FILE_H
+
+/**
+ * Formato binário simples para matrizes densas:
+ *
+ *     cabeçalho de 64 bytes (MatrixFileHeader, little-endian)
+ *     preenchimento até data_offset
+ *     linhas * colunas elementos do tipo `dtype`, em row-major
+ *
+ * `block_rows` é o número de linhas por bloco sugerido por quem escreveu o
+ * arquivo (0 = sem preferência); os leitores podem usá-lo como tamanho de
+ * bloco padrão.
+ *
+ * Leitura:
+ *  - num nó só, matrix_file_map mapeia o arquivo e cada processo lê as suas
+ *    linhas direto do page cache, que é compartilhado entre os processos;
+ *  - em vários nós, cada processo lê o seu bloco de linhas com
+ *    matrix_file_read_rows (MPI_File_read_at_all, coletiva), então a carga é
+ *    uma leitura paralela de cada fatia e não passa pelo rank 0.
+ *
+ * As funções MPI só existem quando este arquivo é incluído depois de
+ * <mpi.h>. Header-only: basta incluir (compilar com -I<raiz>/common).
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MATRIX_FILE_MAGIC "MATRIXF1"
+#define MATRIX_FILE_DATA_OFFSET 64 // dados alinhados à linha de cache
+
+#define MATRIX_INT32   1
+#define MATRIX_INT64   2
+#define MATRIX_FLOAT32 3
+#define MATRIX_FLOAT64 4
+
+typedef struct {
+    char magic[8];        // MATRIX_FILE_MAGIC, sem '\0'
+    int64_t rows;
+    int64_t cols;
+    int32_t dtype;        // MATRIX_INT32, MATRIX_INT64, ...
+    int32_t block_rows;   // linhas por bloco sugeridas (0 = sem preferência)
+    int64_t data_offset;  // início dos dados, em bytes
+    char reserved[24];
+} MatrixFileHeader;
+
+typedef struct {
+    void *base;           // início do mapeamento (cabeçalho)
+    size_t size;
+    const void *data;     // primeiro elemento
+} MatrixMapping;
+
+static inline size_t matrix_dtype_size(int dtype) {
+    switch (dtype) {
+    case MATRIX_INT32:   return 4;
+    case MATRIX_INT64:   return 8;
+    case MATRIX_FLOAT32: return 4;
+    case MATRIX_FLOAT64: return 8;
+    default:             return 0;
+    }
+}
+
+static inline void matrix_file_header_init(MatrixFileHeader *h, long long rows, long long cols,
+                                           int dtype, int block_rows) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, MATRIX_FILE_MAGIC, sizeof(h->magic));
+    h->rows = rows;
+    h->cols = cols;
+    h->dtype = dtype;
+    h->block_rows = block_rows;
+    h->data_offset = MATRIX_FILE_DATA_OFFSET;
+}
+
+static inline size_t matrix_file_row_bytes(const MatrixFileHeader *h) {
+    return (size_t)h->cols * matrix_dtype_size(h->dtype);
+}
+
+static inline size_t matrix_file_total_bytes(const MatrixFileHeader *h) {
+    return (size_t)h->data_offset + (size_t)h->rows * matrix_file_row_bytes(h);
+}
+
+/**
+ * Lê e valida o cabeçalho. Devolve 0 se o arquivo está no formato, 1 se não
+ * tem a assinatura (por exemplo, um arquivo só com os dados crus) e -1 em
+ * caso de erro ou cabeçalho inconsistente.
+ */
+static inline int matrix_file_read_header(const char *path, MatrixFileHeader *h) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return -1;
+    size_t got = fread(h, 1, sizeof(*h), f);
+    fseek(f, 0, SEEK_END);
+    long long file_size = ftell(f);
+    fclose(f);
+
+    if (got < sizeof(h->magic) || memcmp(h->magic, MATRIX_FILE_MAGIC, sizeof(h->magic)) != 0) return 1;
+    if (got != sizeof(*h) || h->rows < 0 || h->cols < 0 || matrix_dtype_size(h->dtype) == 0 ||
+        h->data_offset < (int64_t)sizeof(*h) || (long long)matrix_file_total_bytes(h) > file_size) {
+        fprintf(stderr, "%s: invalid matrix header\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Mapeia o arquivo inteiro só para leitura (o sistema pagina sob demanda)
+static inline int matrix_file_map(const char *path, const MatrixFileHeader *h, MatrixMapping *m) {
+    m->base = NULL;
+    m->data = NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    m->size = matrix_file_total_bytes(h);
+    m->base = mmap(NULL, m->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (m->base == MAP_FAILED) {
+        m->base = NULL;
+        return -1;
+    }
+    madvise(m->base, m->size, MADV_SEQUENTIAL);
+    m->data = (const char *)m->base + h->data_offset;
+    return 0;
+}
+
+static inline void matrix_file_unmap(MatrixMapping *m) {
+    if (m->base != NULL) munmap(m->base, m->size);
+    m->base = NULL;
+}
+
+// Ponteiro para a linha `row` de uma matriz mapeada
+static inline const void *matrix_file_mapped_row(const MatrixMapping *m, const MatrixFileHeader *h, long long row) {
+    return (const char *)m->data + (size_t)row * matrix_file_row_bytes(h);
+}
+
+#ifdef MPI_VERSION
+
+// 1 se todos os processos de `comm` estão no mesmo nó (podem usar mmap)
+static inline int matrix_file_single_node(MPI_Comm comm) {
+    MPI_Comm node;
+    int node_size, size;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+    MPI_Comm_size(node, &node_size);
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_free(&node);
+    return node_size == size;
+}
+
+// Tipo MPI de uma linha inteira: contagens em linhas não estouram int
+static inline MPI_Datatype matrix_file_row_type(const MatrixFileHeader *h) {
+    MPI_Datatype row;
+    MPI_Type_contiguous((int)matrix_file_row_bytes(h), MPI_BYTE, &row);
+    MPI_Type_commit(&row);
+    return row;
+}
+
+/**
+ * Lê as linhas [first_row, first_row + rows) para `buf`. Coletiva: todos os
+ * processos de `fh` devem chamar (com rows = 0, se não tiverem nada a ler),
+ * o que permite à implementação MPI-IO agrupar os acessos.
+ */
+static inline int matrix_file_read_rows(MPI_File fh, const MatrixFileHeader *h,
+                                        long long first_row, int rows, void *buf) {
+    MPI_Datatype row = matrix_file_row_type(h);
+    MPI_Offset offset = h->data_offset + (MPI_Offset)first_row * matrix_file_row_bytes(h);
+    int err = MPI_File_read_at_all(fh, offset, buf, rows, row, MPI_STATUS_IGNORE);
+    MPI_Type_free(&row);
+    return err;
+}
+
+// Versão não bloqueante (MPI_File_iread_at_all): `buf` só pode ser usado
+// depois de MPI_Wait em `request`. Permite ler o próximo bloco enquanto o
+// atual é analisado
+static inline int matrix_file_iread_rows(MPI_File fh, const MatrixFileHeader *h,
+                                         long long first_row, int rows, void *buf, MPI_Request *request) {
+    MPI_Datatype row = matrix_file_row_type(h);
+    MPI_Offset offset = h->data_offset + (MPI_Offset)first_row * matrix_file_row_bytes(h);
+    int err = MPI_File_iread_at_all(fh, offset, buf, rows, row, request);
+    MPI_Type_free(&row); // liberar o tipo não afeta a leitura pendente
+    return err;
+}
+
+/**
+ * Cria o arquivo (coletiva). O rank 0 escreve o cabeçalho e o tamanho final
+ * é fixado; as linhas são escritas depois com matrix_file_write_rows.
+ */
+static inline int matrix_file_create(MPI_Comm comm, const char *path, const MatrixFileHeader *h, MPI_File *fh) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    int err = MPI_File_open(comm, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, fh);
+    if (err != MPI_SUCCESS) return err;
+    MPI_File_set_size(*fh, (MPI_Offset)matrix_file_total_bytes(h));
+    if (rank == 0) err = MPI_File_write_at(*fh, 0, h, sizeof(*h), MPI_BYTE, MPI_STATUS_IGNORE);
+    return err;
+}
+
+// Escreve as linhas [first_row, first_row + rows) (coletiva)
+static inline int matrix_file_write_rows(MPI_File fh, const MatrixFileHeader *h,
+                                         long long first_row, int rows, const void *buf) {
+    MPI_Datatype row = matrix_file_row_type(h);
+    MPI_Offset offset = h->data_offset + (MPI_Offset)first_row * matrix_file_row_bytes(h);
+    int err = MPI_File_write_at_all(fh, offset, buf, rows, row, MPI_STATUS_IGNORE);
+    MPI_Type_free(&row);
+    return err;
+}
+
+#endif // MPI_VERSION
+
+#endif // MATRIX_FILE_H
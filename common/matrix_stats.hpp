@@ -0,0 +1,160 @@
+#ifndef MATRIX_STATS_HPP
+#define MATRIX_STATS_HPP
+
+/**
+ * Estatísticas de matriz (contagem, negativos, zeros, mínimo, máximo, média
+ * e variância) com um único caminho quente para todos os analisadores.
+ *
+ *     RunningStats s = stats::analyze(backend, dados, n);
+ *
+ * O tipo do elemento (int32, int64, float, double) é parâmetro de template
+ * e o kernel é sempre stats::reduce (stats_kernels.hpp, vetorizado). O
+ * backend decide só como o trabalho é dividido e combinado:
+ *
+ *     stats::Serial                 um núcleo
+ *     stats::OpenMP                 threads dividem os dados do processo
+ *     stats::Distributed<Serial>    cada rank analisa a sua fatia + MPI_Allreduce
+ *     stats::Distributed<OpenMP>    MPI + OpenMP
+ *     stats::Hierarchical<Local>    como Distributed, combinando primeiro
+ *                                   dentro do nó (node_reduce.h)
+ *
+ * Todas as partes são combinadas pela fórmula de Chan (running_stats.h). Os
+ * backends MPI só existem quando este arquivo é incluído depois de <mpi.h>;
+ * sem -fopenmp, stats::OpenMP roda em uma thread só.
+ *
+ * Header-only: basta incluir (compilar com -I<raiz>/common).
+ */
+
+#include <cstddef>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "stats_kernels.hpp"
+#ifdef MPI_VERSION
+#include "node_reduce.h"
+#endif
+
+namespace stats {
+
+struct Serial {
+    const char *name() const { return "serial"; }
+
+    template <class T>
+    RunningStats local(const T *v, std::size_t n) const {
+        RunningStats s;
+        running_stats_init(&s);
+        reduce(&s, v, n);
+        return s;
+    }
+
+    RunningStats combine(const RunningStats &s) const { return s; }
+};
+
+struct OpenMP {
+    int threads = 0; // 0 = padrão do OpenMP (OMP_NUM_THREADS)
+
+    const char *name() const { return "openmp"; }
+
+    /**
+     * Cada thread analisa uma fatia contígua (alinhada aos blocos do kernel)
+     * e guarda o resultado na sua posição; a combinação é feita depois, em
+     * ordem de thread, então o resultado não depende do escalonamento.
+     */
+    template <class T>
+    RunningStats local(const T *v, std::size_t n) const {
+#ifdef _OPENMP
+        int team = threads > 0 ? threads : omp_get_max_threads();
+        std::vector<RunningStats> partial(team);
+        #pragma omp parallel num_threads(team)
+        {
+            int t = omp_get_thread_num(), nt = omp_get_num_threads();
+            std::size_t blocks = (n + STATS_KERNEL_BLOCK - 1) / STATS_KERNEL_BLOCK;
+            std::size_t first = blocks * t / nt * STATS_KERNEL_BLOCK;
+            std::size_t last = blocks * (t + 1) / nt * STATS_KERNEL_BLOCK;
+            if (last > n) last = n;
+            running_stats_init(&partial[t]);
+            if (first < last) reduce(&partial[t], v + first, last - first);
+        }
+        RunningStats s;
+        running_stats_init(&s);
+        for (const RunningStats &p : partial) running_stats_merge(&s, &p);
+        return s;
+#else
+        return Serial().local(v, n);
+#endif
+    }
+
+    RunningStats combine(const RunningStats &s) const { return s; }
+};
+
+#ifdef MPI_VERSION
+
+// Cada rank analisa a sua fatia com o backend `Local` e um único
+// MPI_Allreduce com a operação de running_stats.h combina tudo
+template <class Local>
+struct Distributed {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    Local node;
+
+    const char *name() const;
+
+    template <class T>
+    RunningStats local(const T *v, std::size_t n) const { return node.local(v, n); }
+
+    RunningStats combine(const RunningStats &s) const {
+        MPI_Datatype type;
+        MPI_Op op;
+        running_stats_mpi_init(&type, &op);
+        RunningStats global;
+        MPI_Allreduce(&s, &global, 1, type, op, comm);
+        running_stats_mpi_free(&type, &op);
+        return global;
+    }
+};
+
+template <> inline const char *Distributed<Serial>::name() const { return "mpi"; }
+template <> inline const char *Distributed<OpenMP>::name() const { return "mpi+openmp"; }
+
+// Como Distributed, mas a combinação é hierárquica: os ranks de um nó se
+// combinam por uma janela de memória compartilhada e só um líder por nó
+// participa do MPI_Allreduce. ranks_per_node > 0 emula nós desse tamanho
+// numa máquina só (para testes)
+template <class Local>
+struct Hierarchical {
+    Local node;
+    mutable NodeReducer reducer;
+
+    explicit Hierarchical(MPI_Comm comm = MPI_COMM_WORLD, int ranks_per_node = 0) {
+        if (ranks_per_node > 0) node_reduce_init_emulated(&reducer, comm, ranks_per_node);
+        else node_reduce_init(&reducer, comm);
+    }
+    ~Hierarchical() { node_reduce_free(&reducer); }
+    Hierarchical(const Hierarchical &) = delete;
+    Hierarchical &operator=(const Hierarchical &) = delete;
+
+    const char *name() const;
+
+    template <class T>
+    RunningStats local(const T *v, std::size_t n) const { return node.local(v, n); }
+
+    RunningStats combine(const RunningStats &s) const {
+        RunningStats global;
+        node_allreduce(&reducer, &s, &global);
+        return global;
+    }
+};
+
+template <> inline const char *Hierarchical<Serial>::name() const { return "mpi-hier"; }
+template <> inline const char *Hierarchical<OpenMP>::name() const { return "mpi+omp-hier"; }
+
+#endif // MPI_VERSION
+
+template <class Backend, class T>
+inline RunningStats analyze(const Backend &backend, const T *v, std::size_t n) {
+    return backend.combine(backend.local(v, n));
+}
+
+} // namespace stats
+
+#endif // MATRIX_STATS_HPP
@@ -0,0 +1,313 @@
+#ifndef MONTECARLO_HPP
+#define MONTECARLO_HPP
+
+/**
+ * Integração de Monte Carlo genérica, paralela em OpenMP e MPI.
+ *
+ *     struct F { double operator()(const double *x) const { ... } };
+ *     mc::Domain<3> box = {{0, 0, 0}, {1, 1, 1}};
+ *     mc::Result r = mc::integrate(F(), box, mc::Stratified(), options);
+ *     // r.value ± r.std_error
+ *
+ * O integrando é um functor C++ de D coordenadas, avaliado em lotes de
+ * PHILOX_BATCH pontos dentro de um laço `omp simd`: com um functor sem
+ * desvios (e funções matemáticas vetorizáveis), a geração dos pontos e a
+ * avaliação saem vetorizadas.
+ *
+ * As amostras são divididas em "células", cada uma com o mesmo número de
+ * pontos e o seu RunningStats (running_stats.h):
+ *
+ *     mc::Stratified  estratificado: o domínio é dividido em k^D caixas
+ *                     iguais (k por dimensão; k = 1 é Monte Carlo simples)
+ *                     e cada caixa recebe pontos Philox. Erro pela soma das
+ *                     variâncias de cada estrato.
+ *     mc::Sobol       quase aleatório (Sobol, até SOBOL_MAX_DIM dimensões):
+ *                     R réplicas da mesma sequência, cada uma com um
+ *                     deslocamento digital aleatório (RQMC). Erro pela
+ *                     dispersão das R estimativas.
+ *
+ * O índice global de amostras é dividido em faixas contíguas entre ranks e
+ * depois entre threads; cada thread acumula as células que toca, as threads
+ * são combinadas em ordem e os ranks por um MPI_Allreduce com a operação de
+ * running_stats.h. Cada ponto depende só do seu índice e da semente, então
+ * o resultado não depende do número de threads nem do escalonamento.
+ *
+ * As partes MPI só existem quando este arquivo é incluído depois de
+ * <mpi.h>. Header-only: basta incluir (compilar com -I<raiz>/common).
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "philox.h"
+#include "stats_kernels.hpp"
+
+namespace mc {
+
+constexpr long long MAX_CELLS = 4096; // células acumuladas por thread/rank
+constexpr int SOBOL_MAX_DIM = 8;
+
+template <int D>
+struct Domain {
+    double lo[D];
+    double hi[D];
+
+    double volume() const {
+        double v = 1.0;
+        for (int d = 0; d < D; d++) v *= hi[d] - lo[d];
+        return v;
+    }
+};
+
+// Divisão das amostras: `cells` células de `per_cell` pontos cada
+struct Plan {
+    long long cells;
+    std::uint64_t per_cell;
+    int per_dim; // estratos por dimensão (só Stratified)
+};
+
+struct Result {
+    double value;
+    double std_error;
+    std::uint64_t samples; // pontos de fato avaliados (cells * per_cell)
+    long long cells;
+};
+
+struct Options {
+    std::uint64_t samples = 1000000;
+    std::uint64_t seed = 42;
+    int threads = 0; // 0 = padrão do OpenMP (OMP_NUM_THREADS)
+#ifdef MPI_VERSION
+    MPI_Comm comm = MPI_COMM_NULL; // MPI_COMM_NULL: só o processo local
+#endif
+};
+
+// Variância amostral (n - 1) de uma célula
+inline double sample_variance(const RunningStats &s) {
+    return s.count > 1 ? s.m2 / static_cast<double>(s.count - 1) : 0.0;
+}
+
+struct Stratified {
+    int per_dim = 0; // 0 = o maior k com k^D <= min(MAX_CELLS, amostras / 2)
+
+    const char *name() const { return "estratificado"; }
+
+    // k^D células cabem: no máximo MAX_CELLS e pelo menos 2 amostras em cada
+    // (k^D em double: não estoura para k grande)
+    template <int D>
+    static bool fits(int k, std::uint64_t samples) {
+        double cells = std::pow(static_cast<double>(k), D);
+        return k >= 1 && cells <= static_cast<double>(MAX_CELLS) && 2.0 * cells <= static_cast<double>(samples);
+    }
+
+    // Um per_dim que não cabe é reduzido ao maior k que cabe (quem quiser
+    // avisar o usuário confere antes com fits)
+    template <int D>
+    Plan plan(std::uint64_t samples) const {
+        int k = 1;
+        while ((per_dim <= 0 || k < per_dim) && fits<D>(k + 1, samples)) k++;
+        long long cells = 1;
+        for (int d = 0; d < D; d++) cells *= k;
+        std::uint64_t per_cell = samples / static_cast<std::uint64_t>(cells);
+        return {cells, per_cell < 2 ? 2 : per_cell, k};
+    }
+
+    // Pontos i .. i + PHILOX_BATCH - 1 (globais) da célula `cell`: a palavra
+    // d % 4 do bloco Philox de contador i na sequência d / 4 dá a posição
+    // dentro do estrato, na dimensão d
+    template <int D>
+    void points(const Domain<D> &domain, const Plan &plan, long long cell, std::uint64_t, std::uint64_t i,
+                std::uint64_t seed, double x[D][PHILOX_BATCH]) const {
+        uint32_t r[4][PHILOX_BATCH];
+        long long rest = cell;
+        for (int d = 0; d < D; d++) {
+            if (d % 4 == 0) philox_batch(seed, static_cast<uint32_t>(d / 4), i, r);
+            double width = (domain.hi[d] - domain.lo[d]) / plan.per_dim;
+            double origin = domain.lo[d] + width * static_cast<double>(rest % plan.per_dim);
+            rest /= plan.per_dim;
+            #pragma omp simd
+            for (int l = 0; l < PHILOX_BATCH; l++) x[d][l] = origin + width * philox_to_unit(r[d % 4][l]);
+        }
+    }
+
+    // Soma das médias dos estratos (pesos iguais) e das suas variâncias
+    Result finish(const std::vector<RunningStats> &cells, const Plan &plan, double volume) const {
+        double weight = volume / static_cast<double>(plan.cells);
+        double value = 0.0, variance = 0.0;
+        for (const RunningStats &c : cells) {
+            value += weight * c.mean;
+            variance += weight * weight * sample_variance(c) / static_cast<double>(c.count);
+        }
+        return {value, std::sqrt(variance), plan.per_cell * static_cast<std::uint64_t>(plan.cells), plan.cells};
+    }
+};
+
+/**
+ * Direções de Sobol de 32 bits (Joe e Kuo, new-joe-kuo-6.21201) para as
+ * primeiras SOBOL_MAX_DIM dimensões: v[d][b] é o número de direção do bit b.
+ */
+struct SobolDirections {
+    uint32_t v[SOBOL_MAX_DIM][32];
+
+    SobolDirections() {
+        // grau s, coeficientes a e m iniciais do polinômio primitivo de cada
+        // dimensão (a primeira é a sequência de van der Corput)
+        static const int s[SOBOL_MAX_DIM] = {0, 1, 2, 3, 3, 4, 4, 5};
+        static const int a[SOBOL_MAX_DIM] = {0, 0, 1, 1, 2, 1, 4, 2};
+        static const uint32_t m[SOBOL_MAX_DIM][5] = {
+            {0}, {1}, {1, 3}, {1, 3, 1}, {1, 1, 1}, {1, 1, 3, 3}, {1, 3, 5, 13}, {1, 1, 5, 5, 17}};
+        for (int b = 0; b < 32; b++) v[0][b] = 1u << (31 - b);
+        for (int d = 1; d < SOBOL_MAX_DIM; d++) {
+            for (int b = 0; b < s[d]; b++) v[d][b] = m[d][b] << (31 - b);
+            for (int b = s[d]; b < 32; b++) {
+                uint32_t x = v[d][b - s[d]] ^ (v[d][b - s[d]] >> s[d]);
+                for (int k = 1; k < s[d]; k++)
+                    if ((a[d] >> (s[d] - 1 - k)) & 1) x ^= v[d][b - k];
+                v[d][b] = x;
+            }
+        }
+    }
+
+    static const SobolDirections &get() {
+        static const SobolDirections directions;
+        return directions;
+    }
+};
+
+struct Sobol {
+    int replicates = 16;
+
+    const char *name() const { return "sobol"; }
+
+    // Índices de 32 bits: no máximo 2^32 pontos por réplica
+    template <int D>
+    Plan plan(std::uint64_t samples) const {
+        static_assert(D <= SOBOL_MAX_DIM, "Sobol: dimensão acima de SOBOL_MAX_DIM");
+        std::uint64_t per_cell = samples / static_cast<std::uint64_t>(replicates);
+        if (per_cell > 0xFFFFFFFFull) per_cell = 0xFFFFFFFFull;
+        return {replicates, per_cell < 1 ? 1 : per_cell, 0};
+    }
+
+    // Pontos j .. j + PHILOX_BATCH - 1 da réplica `cell`: o ponto de Sobol de
+    // índice j (código de Gray, calculado direto, sem depender do anterior)
+    // com o deslocamento digital (XOR) sorteado para a réplica
+    template <int D>
+    void points(const Domain<D> &domain, const Plan &, long long cell, std::uint64_t j, std::uint64_t,
+                std::uint64_t seed, double x[D][PHILOX_BATCH]) const {
+        const SobolDirections &dir = SobolDirections::get();
+        uint32_t shift[4];
+        for (int d = 0; d < D; d++) {
+            if (d % 4 == 0) philox_block(seed, 0x50B01u + static_cast<uint32_t>(d / 4), static_cast<uint64_t>(cell), shift);
+            double width = domain.hi[d] - domain.lo[d];
+            #pragma omp simd
+            for (int l = 0; l < PHILOX_BATCH; l++) {
+                uint32_t index = static_cast<uint32_t>(j + static_cast<std::uint64_t>(l));
+                uint32_t gray = index ^ (index >> 1), u = shift[d % 4];
+                for (int b = 0; b < 32; b++) u ^= dir.v[d][b] & (0u - ((gray >> b) & 1u));
+                x[d][l] = domain.lo[d] + width * philox_to_unit(u);
+            }
+        }
+    }
+
+    // Média das R estimativas e erro padrão pela dispersão entre elas
+    Result finish(const std::vector<RunningStats> &cells, const Plan &plan, double volume) const {
+        RunningStats estimates;
+        running_stats_init(&estimates);
+        for (const RunningStats &c : cells) running_stats_push(&estimates, volume * c.mean);
+        double error = std::sqrt(sample_variance(estimates) / static_cast<double>(estimates.count));
+        return {estimates.mean, error, plan.per_cell * static_cast<std::uint64_t>(plan.cells), plan.cells};
+    }
+};
+
+// Acumula em `cells` as amostras globais [first, last)
+template <int D, class F, class Sampler>
+void accumulate(const F &f, const Domain<D> &domain, const Sampler &sampler, const Plan &plan,
+                std::uint64_t seed, std::uint64_t first, std::uint64_t last, RunningStats *cells) {
+    double x[D][PHILOX_BATCH];
+    double fx[stats::STATS_KERNEL_BLOCK + PHILOX_BATCH];
+    std::uint64_t i = first;
+    while (i < last) {
+        long long cell = static_cast<long long>(i / plan.per_cell);
+        std::uint64_t cell_end = static_cast<std::uint64_t>(cell + 1) * plan.per_cell;
+        std::uint64_t end = cell_end < last ? cell_end : last;
+        // Um bloco do kernel de cada vez: pontos e avaliação em lotes, depois
+        // média e M2 do bloco juntados à célula (stats::reduce)
+        while (i < end) {
+            std::size_t len = end - i < stats::STATS_KERNEL_BLOCK ? static_cast<std::size_t>(end - i) : stats::STATS_KERNEL_BLOCK;
+            for (std::size_t k = 0; k < len; k += PHILOX_BATCH) {
+                std::uint64_t index = i + k;
+                sampler.points(domain, plan, cell, index - static_cast<std::uint64_t>(cell) * plan.per_cell, index,
+                               seed, x);
+                #pragma omp simd
+                for (int l = 0; l < PHILOX_BATCH; l++) {
+                    double p[D];
+                    for (int d = 0; d < D; d++) p[d] = x[d][l];
+                    fx[k + l] = f(p);
+                }
+            }
+            stats::reduce(&cells[cell], fx, len);
+            i += len;
+        }
+    }
+}
+
+template <int D, class F, class Sampler>
+Result integrate(const F &f, const Domain<D> &domain, const Sampler &sampler, const Options &opt) {
+    Plan plan = sampler.template plan<D>(opt.samples);
+    std::uint64_t total = plan.per_cell * static_cast<std::uint64_t>(plan.cells);
+
+    // Faixa deste rank: os primeiros total % size ranks ficam com uma amostra a mais
+    std::uint64_t first = 0, count = total;
+#ifdef MPI_VERSION
+    if (opt.comm != MPI_COMM_NULL) {
+        int rank, size;
+        MPI_Comm_rank(opt.comm, &rank);
+        MPI_Comm_size(opt.comm, &size);
+        std::uint64_t base = total / size, extra = total % size;
+        first = rank * base + (static_cast<std::uint64_t>(rank) < extra ? rank : extra);
+        count = base + (static_cast<std::uint64_t>(rank) < extra ? 1 : 0);
+    }
+#endif
+
+    std::vector<RunningStats> cells(plan.cells);
+    for (RunningStats &c : cells) running_stats_init(&c);
+#ifdef _OPENMP
+    // Cada thread acumula a sua fatia contígua em células próprias; a
+    // combinação é feita em ordem de thread, como em stats::OpenMP
+    int team = opt.threads > 0 ? opt.threads : omp_get_max_threads();
+    std::vector<std::vector<RunningStats>> partial(team);
+    #pragma omp parallel num_threads(team)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        std::vector<RunningStats> &mine = partial[t];
+        mine.resize(plan.cells);
+        for (RunningStats &c : mine) running_stats_init(&c);
+        std::uint64_t a = first + count * t / nt, b = first + count * (t + 1) / nt;
+        accumulate(f, domain, sampler, plan, opt.seed, a, b, mine.data());
+    }
+    for (const std::vector<RunningStats> &p : partial)
+        for (long long c = 0; c < plan.cells && !p.empty(); c++) running_stats_merge(&cells[c], &p[c]);
+#else
+    accumulate(f, domain, sampler, plan, opt.seed, first, first + count, cells.data());
+#endif
+
+#ifdef MPI_VERSION
+    if (opt.comm != MPI_COMM_NULL) {
+        MPI_Datatype type;
+        MPI_Op op;
+        running_stats_mpi_init(&type, &op);
+        // plan.cells <= MAX_CELLS (Stratified) ou = réplicas (Sobol): cabe num int
+        MPI_Allreduce(MPI_IN_PLACE, cells.data(), static_cast<int>(plan.cells), type, op, opt.comm);
+        running_stats_mpi_free(&type, &op);
+    }
+#endif
+    return sampler.finish(cells, plan, domain.volume());
+}
+
+} // namespace mc
+
+#endif // MONTECARLO_HPP
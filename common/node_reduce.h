@@ -0,0 +1,131 @@
+#ifndef NODE_REDUCE_H
+#define NODE_REDUCE_H
+
+/**
+ * Redução hierárquica de RunningStats, ciente dos nós:
+ *
+ *  1. os ranks de um mesmo nó (MPI_Comm_split_type com
+ *     MPI_COMM_TYPE_SHARED) escrevem o seu RunningStats numa janela de
+ *     memória compartilhada MPI-3 e o líder do nó (rank 0 do nó) combina
+ *     as entradas em ordem, sem mensagens;
+ *  2. só os líderes, um por nó, reduzem entre nós (MPI_Reduce ou
+ *     MPI_Allreduce com a operação de running_stats.h).
+ *
+ * Com P ranks por nó, o número de mensagens entre nós cai por um fator P
+ * em relação a reduzir direto em MPI_COMM_WORLD. Uso:
+ *
+ *     NodeReducer reducer;
+ *     node_reduce_init(&reducer, MPI_COMM_WORLD);
+ *     node_reduce(&reducer, &local, &global);   // resultado no rank 0
+ *     node_reduce_free(&reducer);
+ *
+ * node_reduce_init_emulated agrupa os ranks em "nós" de tamanho fixo por
+ * número de rank, para testar o caminho entre nós numa máquina só (todos os
+ * ranks precisam estar, de fato, na mesma máquina).
+ *
+ * Incluir depois de <mpi.h>. Header-only: basta incluir (compilar com
+ * -I<raiz>/common).
+ */
+
+#include "running_stats.h"
+
+typedef struct {
+    MPI_Comm node;        // ranks do mesmo nó
+    MPI_Comm leaders;     // um rank por nó (MPI_COMM_NULL nos outros)
+    int node_rank, node_size;
+    MPI_Win win;
+    RunningStats *slots;  // node_size entradas + 1 para o resultado, no líder
+    MPI_Datatype type;
+    MPI_Op op;
+} NodeReducer;
+
+static inline void node_reduce_setup(NodeReducer *r, MPI_Comm comm, MPI_Comm node) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    r->node = node;
+    MPI_Comm_rank(node, &r->node_rank);
+    MPI_Comm_size(node, &r->node_size);
+
+    // A chave é o rank em `comm`, então o rank 0 de `comm` é líder do seu nó
+    // e também o rank 0 entre os líderes (raiz da redução)
+    MPI_Comm_split(comm, r->node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &r->leaders);
+
+    // A janela inteira fica na memória do líder; os outros só a enxergam
+    MPI_Aint bytes = r->node_rank == 0 ? (MPI_Aint)(r->node_size + 1) * sizeof(RunningStats) : 0;
+    MPI_Win_allocate_shared(bytes, sizeof(RunningStats), MPI_INFO_NULL, node, &r->slots, &r->win);
+    if (r->node_rank != 0) {
+        MPI_Aint size;
+        int disp_unit;
+        MPI_Win_shared_query(r->win, 0, &size, &disp_unit, &r->slots);
+    }
+    // Época passiva aberta durante toda a vida do redutor: a sincronização
+    // é feita com MPI_Win_sync + barreira no nó
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, r->win);
+
+    running_stats_mpi_init(&r->type, &r->op);
+}
+
+static inline void node_reduce_init(NodeReducer *r, MPI_Comm comm) {
+    int rank;
+    MPI_Comm node;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+    node_reduce_setup(r, comm, node);
+}
+
+static inline void node_reduce_init_emulated(NodeReducer *r, MPI_Comm comm, int ranks_per_node) {
+    int rank;
+    MPI_Comm node;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_split(comm, rank / ranks_per_node, rank, &node);
+    node_reduce_setup(r, comm, node);
+}
+
+// Torna visíveis as escritas na janela e espera todos do nó
+static inline void node_reduce_sync(NodeReducer *r) {
+    MPI_Win_sync(r->win);
+    MPI_Barrier(r->node);
+    MPI_Win_sync(r->win);
+}
+
+// Fase do nó: devolve no líder a combinação dos RunningStats do nó
+static inline RunningStats node_reduce_local(NodeReducer *r, const RunningStats *local) {
+    // A barreira inicial garante que o líder já leu as entradas da chamada
+    // anterior antes de alguém sobrescrevê-las
+    MPI_Barrier(r->node);
+    r->slots[r->node_rank] = *local;
+    node_reduce_sync(r);
+
+    RunningStats node_stats;
+    running_stats_init(&node_stats);
+    if (r->node_rank == 0)
+        for (int i = 0; i < r->node_size; i++) running_stats_merge(&node_stats, &r->slots[i]);
+    return node_stats;
+}
+
+// Resultado em `global` no rank 0 do comunicador original
+static inline void node_reduce(NodeReducer *r, const RunningStats *local, RunningStats *global) {
+    RunningStats node_stats = node_reduce_local(r, local);
+    if (r->node_rank == 0)
+        MPI_Reduce(&node_stats, global, 1, r->type, r->op, 0, r->leaders);
+}
+
+// Resultado em `global` em todos os ranks (o líder o publica na janela)
+static inline void node_allreduce(NodeReducer *r, const RunningStats *local, RunningStats *global) {
+    RunningStats node_stats = node_reduce_local(r, local);
+    if (r->node_rank == 0) {
+        MPI_Allreduce(&node_stats, &r->slots[r->node_size], 1, r->type, r->op, r->leaders);
+    }
+    node_reduce_sync(r);
+    *global = r->slots[r->node_size];
+}
+
+static inline void node_reduce_free(NodeReducer *r) {
+    running_stats_mpi_free(&r->type, &r->op);
+    MPI_Win_unlock_all(r->win);
+    MPI_Win_free(&r->win);
+    if (r->leaders != MPI_COMM_NULL) MPI_Comm_free(&r->leaders);
+    MPI_Comm_free(&r->node);
+}
+
+#endif // NODE_REDUCE_H
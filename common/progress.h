@@ -0,0 +1,257 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+/**
+ * Barra de progresso de baixo custo para laços longos com threads.
+ *
+ *     Progress p;
+ *     progress_start(&p, "soma", n, omp_get_max_threads(), 0);
+ *     #pragma omp parallel for
+ *     for (long long i = 0; i < n; i++) {
+ *         ...
+ *         progress_add(&p, omp_get_thread_num(), 1);
+ *     }
+ *     progress_finish(&p);
+ *
+ * Cada thread só escreve no seu contador (um ProgressSlot por linha de
+ * cache, sem operação atômica de leitura-modificação-escrita: um load e um
+ * store relaxed, o mesmo custo de `x++` numa variável local em memória).
+ * Uma única thread de relatório lê os contadores a cada PROGRESS_INTERVAL_MS
+ * e desenha a barra; as threads de trabalho nunca chamam printf, fflush nem
+ * esperam pela saída. Nada de códigos ANSI e fflush a cada iteração, todos
+ * serializados no stdout, como no second.c da Aula page 54.
+ *
+ * Em um terminal a barra é redesenhada na mesma linha (com per_slot, uma
+ * barra por slot embaixo). Fora de um terminal (arquivo, pipe, mpirun) sai
+ * uma linha de texto a cada PROGRESS_LOG_INTERVAL_MS.
+ *
+ * Para os programas que chamam o ffmpeg (work-Final, work-Optionals),
+ * progress_ffmpeg executa o comando com `-progress pipe:1` e avança o slot
+ * com o tempo de vídeo já codificado; progress_media_duration_us (ffprobe)
+ * dá o total.
+ *
+ * Header-only: basta incluir (compilar com -pthread -I<raiz>/common).
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PROGRESS_CACHE_LINE 64
+#define PROGRESS_BAR_WIDTH 40
+#define PROGRESS_INTERVAL_MS 100      // atualização no terminal (10 por segundo)
+#define PROGRESS_LOG_INTERVAL_MS 2000 // uma linha a cada 2 s fora do terminal
+#define PROGRESS_MAX_SLOTS 256
+
+// Contador de uma thread, sozinho na sua linha de cache
+typedef struct {
+    _Alignas(PROGRESS_CACHE_LINE) atomic_llong done;
+    long long total; // total do slot, para as barras por slot (0 = desconhecido)
+} ProgressSlot;
+
+typedef struct {
+    ProgressSlot *slots;
+    int nslots;
+    long long total;   // soma esperada dos contadores (0 = desconhecido: sem % nem ETA)
+    const char *label;
+    const char *unit;  // unidade exibida (progress_set_unit)
+    double scale;      // contador * scale = valor exibido
+    int per_slot;
+    FILE *out;
+    int tty;
+    int lines;         // linhas desenhadas no último quadro (terminal)
+    struct timespec start;
+    pthread_t reporter;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    int stop;
+} Progress;
+
+static inline double progress_elapsed(const Progress *p) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - p->start.tv_sec) + (now.tv_nsec - p->start.tv_nsec) * 1e-9;
+}
+
+// Chamado só pela thread de trabalho dona do slot
+static inline void progress_add(Progress *p, int slot, long long n) {
+    atomic_llong *c = &p->slots[slot].done;
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static inline void progress_set(Progress *p, int slot, long long value) {
+    atomic_store_explicit(&p->slots[slot].done, value, memory_order_relaxed);
+}
+
+static inline long long progress_get(Progress *p, int slot) {
+    return atomic_load_explicit(&p->slots[slot].done, memory_order_relaxed);
+}
+
+// Total próprio de um slot (para as barras por slot); chamar antes do trabalho
+static inline void progress_slot_total(Progress *p, int slot, long long total) { p->slots[slot].total = total; }
+
+// Unidade e escala da exibição, ex.: progress_set_unit(&p, "s", 1e-6) para
+// contadores em microssegundos
+static inline void progress_set_unit(Progress *p, const char *unit, double scale) {
+    p->unit = unit;
+    p->scale = scale;
+}
+
+static inline int progress_draw_bar(char *dst, size_t size, double fraction) {
+    char bar[PROGRESS_BAR_WIDTH + 1];
+    int full = (int)(fraction * PROGRESS_BAR_WIDTH);
+    if (full > PROGRESS_BAR_WIDTH) full = PROGRESS_BAR_WIDTH;
+    for (int i = 0; i < PROGRESS_BAR_WIDTH; i++) bar[i] = i < full ? '=' : (i == full ? '>' : ' ');
+    bar[PROGRESS_BAR_WIDTH] = '\0';
+    return snprintf(dst, size, "[%s] %5.1f%%", bar, 100.0 * fraction);
+}
+
+// Um quadro inteiro num buffer e um único fputs: a saída não se mistura
+static inline void progress_render(Progress *p, int final) {
+    char frame[(PROGRESS_BAR_WIDTH + 96) * (PROGRESS_MAX_SLOTS + 1) + 16];
+    size_t len = 0;
+    long long done = 0;
+    for (int s = 0; s < p->nslots; s++) done += progress_get(p, s);
+    double elapsed = progress_elapsed(p), shown = done * p->scale;
+    const char *sep = p->unit[0] != '\0' ? " " : ""; // entre número e unidade
+
+    if (p->tty && p->lines > 1) len += snprintf(frame + len, sizeof frame - len, "\033[%dA", p->lines - 1);
+    if (p->tty) len += snprintf(frame + len, sizeof frame - len, "\r\033[K");
+    len += snprintf(frame + len, sizeof frame - len, "%s ", p->label);
+    if (p->total > 0) {
+        double fraction = (double)done / p->total;
+        len += progress_draw_bar(frame + len, sizeof frame - len, fraction > 1.0 ? 1.0 : fraction);
+        len += snprintf(frame + len, sizeof frame - len, "  %.1f/%.1f%s%s", shown, p->total * p->scale, sep, p->unit);
+    } else {
+        len += snprintf(frame + len, sizeof frame - len, "%.1f%s%s", shown, sep, p->unit);
+    }
+    len += snprintf(frame + len, sizeof frame - len, "  %.1f s", elapsed);
+    if (elapsed > 0 && done > 0) {
+        len += snprintf(frame + len, sizeof frame - len, "  %.3g%s%s/s", shown / elapsed, sep, p->unit);
+        if (p->total > 0 && !final && done < p->total)
+            len += snprintf(frame + len, sizeof frame - len, "  ETA %.1f s", elapsed * (p->total - done) / done);
+    }
+    int lines = 1;
+    if (p->tty && p->per_slot) {
+        for (int s = 0; s < p->nslots && len < sizeof frame - PROGRESS_BAR_WIDTH - 96; s++) {
+            long long d = progress_get(p, s), t = p->slots[s].total;
+            len += snprintf(frame + len, sizeof frame - len, "\n\033[K  %3d ", s);
+            if (t > 0) len += progress_draw_bar(frame + len, sizeof frame - len, d >= t ? 1.0 : (double)d / t);
+            else len += snprintf(frame + len, sizeof frame - len, "%.1f%s%s", d * p->scale, sep, p->unit);
+            lines++;
+        }
+    }
+    if (!p->tty || final) len += snprintf(frame + len, sizeof frame - len, "\n");
+    p->lines = lines;
+    fputs(frame, p->out);
+    fflush(p->out);
+}
+
+static inline void *progress_reporter(void *arg) {
+    Progress *p = (Progress *)arg;
+    int interval = p->tty ? PROGRESS_INTERVAL_MS : PROGRESS_LOG_INTERVAL_MS;
+    pthread_mutex_lock(&p->mutex);
+    while (!p->stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_nsec += (long)interval * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        while (!p->stop && pthread_cond_timedwait(&p->wake, &p->mutex, &deadline) == 0) {
+        }
+        if (p->stop) break;
+        pthread_mutex_unlock(&p->mutex);
+        progress_render(p, 0);
+        pthread_mutex_lock(&p->mutex);
+    }
+    pthread_mutex_unlock(&p->mutex);
+    return NULL;
+}
+
+// Começa o relatório em stderr: `total` na unidade dos contadores (0 se
+// desconhecido), um slot por thread. Devolve 0, ou -1 sem memória/thread
+static inline int progress_start(Progress *p, const char *label, long long total, int nslots, int per_slot) {
+    if (nslots < 1) nslots = 1;
+    if (nslots > PROGRESS_MAX_SLOTS) nslots = PROGRESS_MAX_SLOTS;
+    p->slots = (ProgressSlot *)aligned_alloc(PROGRESS_CACHE_LINE, nslots * sizeof(ProgressSlot));
+    if (p->slots == NULL) return -1;
+    for (int s = 0; s < nslots; s++) {
+        atomic_init(&p->slots[s].done, 0);
+        p->slots[s].total = 0;
+    }
+    p->nslots = nslots;
+    p->total = total;
+    p->label = label;
+    p->unit = "";
+    p->scale = 1.0;
+    p->per_slot = per_slot;
+    p->out = stderr;
+    p->tty = isatty(fileno(stderr));
+    p->lines = 0;
+    p->stop = 0;
+    clock_gettime(CLOCK_MONOTONIC, &p->start);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&p->wake, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&p->mutex, NULL);
+    if (pthread_create(&p->reporter, NULL, progress_reporter, p) != 0) {
+        free(p->slots);
+        return -1;
+    }
+    return 0;
+}
+
+// Para a thread de relatório, desenha o quadro final e libera os slots
+static inline void progress_finish(Progress *p) {
+    pthread_mutex_lock(&p->mutex);
+    p->stop = 1;
+    pthread_cond_signal(&p->wake);
+    pthread_mutex_unlock(&p->mutex);
+    pthread_join(p->reporter, NULL);
+    progress_render(p, 1);
+    pthread_cond_destroy(&p->wake);
+    pthread_mutex_destroy(&p->mutex);
+    free(p->slots);
+}
+
+// Duração de um arquivo de mídia em microssegundos (ffprobe), ou 0 se não
+// deu para saber
+static inline long long progress_media_duration_us(const char *file) {
+    char command[1024];
+    snprintf(command, sizeof command,
+             "ffprobe -v error -show_entries format=duration -of default=noprint_wrappers=1:nokey=1 '%s' 2>/dev/null",
+             file);
+    FILE *pipe = popen(command, "r");
+    if (pipe == NULL) return 0;
+    double seconds = 0.0;
+    if (fscanf(pipe, "%lf", &seconds) != 1) seconds = 0.0;
+    pclose(pipe);
+    return (long long)(seconds * 1e6);
+}
+
+// Executa um comando ffmpeg (sem o "ffmpeg" inicial: só os argumentos) e
+// avança `slot` com o tempo já codificado, em microssegundos, somado ao
+// valor que o slot tinha. Devolve o status do comando, como system()
+static inline int progress_ffmpeg(Progress *p, int slot, const char *arguments) {
+    char command[2048];
+    snprintf(command, sizeof command, "ffmpeg -nostdin -nostats -loglevel error -progress pipe:1 %s", arguments);
+    FILE *pipe = popen(command, "r");
+    if (pipe == NULL) return -1;
+    long long base = progress_get(p, slot), last = 0;
+    char line[256];
+    while (fgets(line, sizeof line, pipe) != NULL) {
+        long long us;
+        if (sscanf(line, "out_time_us=%lld", &us) == 1 && us > last) {
+            last = us;
+            progress_set(p, slot, base + us);
+        }
+    }
+    return pclose(pipe);
+}
+
+#endif // PROGRESS_H
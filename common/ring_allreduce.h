@@ -0,0 +1,207 @@
+#ifndef RING_ALLREDUCE_H
+#define RING_ALLREDUCE_H
+
+/**
+ * Allreduce em anel para buffers grandes: reduce-scatter seguido de
+ * allgather, com os dados em segmentos e envios não bloqueantes.
+ *
+ *     ring_allreduce(send, recv, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, NULL);
+ *
+ * É o anel do gerson_ex02.c (cada processo recebe da esquerda e envia para
+ * a direita), mas com o buffer dividido em p pedaços que circulam todos ao
+ * mesmo tempo em vez de um único token:
+ *
+ *   1. reduce-scatter, p-1 passos: no passo s o rank r envia o pedaço
+ *      (r - s) mod p e recebe o (r - s - 1) mod p, que reduz no seu. No fim
+ *      o rank r tem o pedaço (r + 1) mod p completamente reduzido;
+ *   2. allgather, p-1 passos: os pedaços prontos circulam e cada rank copia
+ *      o que recebe.
+ *
+ * Cada rank envia e recebe 2 (p-1)/p do buffer, o mínimo possível
+ * (bandwidth-optimal), contra ~2 log p vezes o buffer de uma árvore binária.
+ * A latência é de 2 (p-1) passos, por isso para buffers pequenos
+ * (min_bytes) a chamada vai direto para o MPI_Allreduce.
+ *
+ * Dentro de cada passo o pedaço vai em segmentos de segment_bytes: todos
+ * os recebimentos são postados com MPI_Irecv, cada segmento é reduzido
+ * assim que chega (MPI_Waitany) e logo reenviado com MPI_Isend como dado do
+ * passo seguinte. Assim o anel funciona como um pipeline: a redução de um
+ * segmento se sobrepõe à transferência dos outros e o passo seguinte começa
+ * antes de o atual terminar. O tamanho do segmento é o parâmetro de ajuste
+ * (ring_bench.c varre vários).
+ *
+ * A operação deve ser comutativa (MPI_SUM, MPI_MAX, ...; a redução usa
+ * MPI_Reduce_local) e o tipo, um tipo pré-definido contíguo. Cada pedaço é
+ * reduzido em uma única ordem e depois copiado, então todos os ranks
+ * terminam com o resultado idêntico bit a bit (em ponto flutuante ele pode
+ * diferir do MPI_Allreduce no último bit, por ser outra ordem de soma).
+ *
+ * As mensagens do anel não passam pelo comm do chamador: na primeira chamada
+ * com um comm ele é duplicado (MPI_Comm_dup, coletiva como a própria
+ * chamada) e a cópia fica guardada num atributo do comm, liberada junto com
+ * ele. Assim as tags 0..RING_MAX_SEGMENTS-1 não se confundem com mensagens
+ * ponto a ponto do programa, como numa coletiva de verdade. A guarda do
+ * atributo não é protegida para várias threads chamando ao mesmo tempo.
+ *
+ * Incluir depois de <mpi.h>. Header-only: basta incluir (compilar com
+ * -I<raiz>/common).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RING_DEFAULT_SEGMENT_BYTES (64 << 10) // 64 KiB por mensagem
+#define RING_DEFAULT_MIN_BYTES (64 << 10)     // abaixo disso, MPI_Allreduce
+#define RING_MAX_SEGMENTS 4096                // segmentos por pedaço (tags 0..4095)
+
+typedef struct {
+    long long segment_bytes; // tamanho de cada mensagem do pipeline
+    long long min_bytes;     // buffers menores vão para o MPI_Allreduce (0 = sempre anel)
+} RingAllreduceOptions;
+
+static inline void ring_allreduce_default_options(RingAllreduceOptions *o) {
+    o->segment_bytes = RING_DEFAULT_SEGMENT_BYTES;
+    o->min_bytes = RING_DEFAULT_MIN_BYTES;
+}
+
+// Pedaço c de p em count elementos: os primeiros count % p ficam com um a mais
+static inline void ring_chunk(long long count, int p, int c, long long *first, long long *len) {
+    long long base = count / p, extra = count % p;
+    *first = c * base + (c < extra ? c : extra);
+    *len = base + (c < extra ? 1 : 0);
+}
+
+static inline int ring_segments(long long len, long long seg) { return (int)((len + seg - 1) / seg); }
+
+// Libera a cópia guardada quando o comm original é liberado
+static inline int ring_comm_delete(MPI_Comm comm, int keyval, void *value, void *extra) {
+    (void)comm;
+    (void)keyval;
+    (void)extra;
+    MPI_Comm *dup = (MPI_Comm *)value;
+    MPI_Comm_free(dup);
+    free(dup);
+    return MPI_SUCCESS;
+}
+
+// Comunicador privado do anel para `comm`: duplicado na primeira chamada e
+// reaproveitado nas seguintes (o custo do dup é pago uma vez)
+static inline int ring_private_comm(MPI_Comm comm, MPI_Comm *ring) {
+    static int keyval = MPI_KEYVAL_INVALID;
+    if (keyval == MPI_KEYVAL_INVALID) {
+        int err = MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, ring_comm_delete, &keyval, NULL);
+        if (err != MPI_SUCCESS) return err;
+    }
+    MPI_Comm *cached;
+    int found;
+    MPI_Comm_get_attr(comm, keyval, &cached, &found);
+    if (!found) {
+        cached = (MPI_Comm *)malloc(sizeof(MPI_Comm));
+        if (cached == NULL) return MPI_ERR_NO_MEM;
+        int err = MPI_Comm_dup(comm, cached);
+        if (err != MPI_SUCCESS) {
+            free(cached);
+            return err;
+        }
+        MPI_Comm_set_attr(comm, keyval, cached);
+    }
+    *ring = *cached;
+    return MPI_SUCCESS;
+}
+
+// recvbuf recebe a redução dos sendbuf de todos os ranks (sendbuf pode ser
+// MPI_IN_PLACE). opt NULL = ring_allreduce_default_options
+static inline int ring_allreduce(const void *sendbuf, void *recvbuf, long long count, MPI_Datatype type, MPI_Op op,
+                                 MPI_Comm comm, const RingAllreduceOptions *opt) {
+    RingAllreduceOptions defaults;
+    if (opt == NULL) {
+        ring_allreduce_default_options(&defaults);
+        opt = &defaults;
+    }
+    int rank, p, type_size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &p);
+    MPI_Type_size(type, &type_size);
+    if (p == 1 || count * type_size < opt->min_bytes || count < p) {
+        if (count > (long long)0x7FFFFFFF) return MPI_ERR_COUNT;
+        return MPI_Allreduce(sendbuf, recvbuf, (int)count, type, op, comm);
+    }
+
+    // Todos os ranks chegam aqui juntos (a decisão acima só depende de count,
+    // type e p), então o MPI_Comm_dup da primeira chamada é coletivo
+    int err = ring_private_comm(comm, &comm);
+    if (err != MPI_SUCCESS) return err;
+
+    char *buf = (char *)recvbuf;
+    if (sendbuf != MPI_IN_PLACE) memcpy(buf, sendbuf, (size_t)count * type_size);
+
+    // Elementos por segmento: limitado para que um pedaço tenha no máximo
+    // RING_MAX_SEGMENTS segmentos e cada um caiba num int
+    long long max_chunk = (count + p - 1) / p;
+    long long seg = opt->segment_bytes / type_size;
+    if (seg < 1) seg = 1;
+    if (seg > 0x7FFFFFFF) seg = 0x7FFFFFFF;
+    if (ring_segments(max_chunk, seg) > RING_MAX_SEGMENTS) seg = (max_chunk + RING_MAX_SEGMENTS - 1) / RING_MAX_SEGMENTS;
+    int max_segs = ring_segments(max_chunk, seg);
+
+    // tmp: o pedaço recebido no passo de reduce-scatter, antes da redução
+    char *tmp = (char *)malloc((size_t)max_chunk * type_size);
+    MPI_Request *recv_req = (MPI_Request *)malloc(max_segs * sizeof(MPI_Request));
+    MPI_Request *send_req = (MPI_Request *)malloc(2 * (size_t)max_segs * sizeof(MPI_Request));
+    if (tmp == NULL || recv_req == NULL || send_req == NULL) {
+        free(tmp);
+        free(recv_req);
+        free(send_req);
+        return MPI_ERR_NO_MEM;
+    }
+
+    int left = (rank - 1 + p) % p, right = (rank + 1) % p;
+    int steps = 2 * (p - 1);
+    int pending_sends = 0; // no máximo dois passos de envios em voo
+
+    // Passo 0: o próprio pedaço rank, direto do buffer
+    long long first, len;
+    ring_chunk(count, p, rank, &first, &len);
+    for (int k = 0; k < ring_segments(len, seg); k++) {
+        long long off = k * seg, n = len - off < seg ? len - off : seg;
+        MPI_Isend(buf + (first + off) * type_size, (int)n, type, right, k, comm, &send_req[pending_sends++]);
+    }
+
+    for (int s = 0; s < steps; s++) {
+        int reduce = s < p - 1;
+        // Pedaço que chega neste passo (e segue no próximo)
+        int c = ((rank - s - 1) % p + p) % p;
+        if (!reduce) c = ((rank - (s - (p - 1))) % p + p) % p;
+        ring_chunk(count, p, c, &first, &len);
+        int nseg = ring_segments(len, seg);
+        char *dst = reduce ? tmp : buf + first * type_size;
+        for (int k = 0; k < nseg; k++) {
+            long long off = k * seg, n = len - off < seg ? len - off : seg;
+            MPI_Irecv(dst + off * type_size, (int)n, type, left, k, comm, &recv_req[k]);
+        }
+
+        int base_sends = pending_sends; // envios do passo anterior ainda não concluídos
+        for (int done = 0; done < nseg; done++) {
+            int k;
+            MPI_Waitany(nseg, recv_req, &k, MPI_STATUS_IGNORE);
+            long long off = k * seg, n = len - off < seg ? len - off : seg;
+            char *mine = buf + (first + off) * type_size;
+            if (reduce) MPI_Reduce_local(tmp + off * type_size, mine, (int)n, type, op);
+            // Pronto: segue para a direita como dado do próximo passo
+            if (s + 1 < steps) MPI_Isend(mine, (int)n, type, right, k, comm, &send_req[pending_sends++]);
+        }
+        // Conclui os envios do passo anterior (os deste ficam em voo,
+        // sobrepostos ao próximo passo)
+        MPI_Waitall(base_sends, send_req, MPI_STATUSES_IGNORE);
+        memmove(send_req, send_req + base_sends, (pending_sends - base_sends) * sizeof(MPI_Request));
+        pending_sends -= base_sends;
+    }
+    MPI_Waitall(pending_sends, send_req, MPI_STATUSES_IGNORE);
+
+    free(tmp);
+    free(recv_req);
+    free(send_req);
+    return MPI_SUCCESS;
+}
+
+#endif // RING_ALLREDUCE_H
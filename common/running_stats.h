@@ -0,0 +1,161 @@
+#ifndef RUNNING_STATS_H
+#define RUNNING_STATS_H
+
+/**
+ * Estatísticas de um passe só, com variância pelo método de Welford/Chan.
+ *
+ * Cada processo (ou thread, ou bloco) acumula a sua parte num RunningStats
+ * e as partes são combinadas com a fórmula paralela de Chan:
+ *
+ *     n     = na + nb
+ *     delta = mean_b - mean_a
+ *     mean  = mean_a + delta * nb / n
+ *     M2    = M2a + M2b + delta^2 * na * nb / n
+ *
+ * Variância = M2 / n. Nada de "soma dos quadrados - média^2" (que perde
+ * precisão e estoura em int) e nada de um segundo passe sobre os dados.
+ *
+ * Quando incluído depois de <mpi.h>, também define uma operação MPI
+ * (running_stats_mpi_init) para que um único MPI_Reduce/MPI_Allreduce
+ * combine tudo de uma vez.
+ *
+ * Header-only: basta incluir (compilar com -I<raiz>/common).
+ */
+
+#include <float.h>
+
+#define RUNNING_STATS_BLOCK 1024 // elementos por bloco em running_stats_add_ints
+
+typedef struct {
+    long long count;
+    double mean;
+    double m2;          // soma dos quadrados dos desvios em relação à média
+    double min, max;    // double representa exatamente qualquer int de 32 bits
+    long long negatives;
+    long long zeros;
+} RunningStats;
+
+static inline void running_stats_init(RunningStats *s) {
+    s->count = 0;
+    s->mean = 0.0;
+    s->m2 = 0.0;
+    s->min = DBL_MAX;
+    s->max = -DBL_MAX;
+    s->negatives = 0;
+    s->zeros = 0;
+}
+
+// Combina `b` em `a` (fórmula de Chan)
+static inline void running_stats_merge(RunningStats *a, const RunningStats *b) {
+    if (b->count == 0) return;
+    if (a->count == 0) {
+        *a = *b;
+        return;
+    }
+    long long n = a->count + b->count;
+    double delta = b->mean - a->mean;
+    a->mean += delta * ((double)b->count / n);
+    a->m2 += b->m2 + delta * delta * ((double)a->count * b->count / n);
+    a->count = n;
+    if (b->min < a->min) a->min = b->min;
+    if (b->max > a->max) a->max = b->max;
+    a->negatives += b->negatives;
+    a->zeros += b->zeros;
+}
+
+/**
+ * Acumula um vetor de inteiros. Os dados são lidos da memória uma única vez:
+ * cada bloco de RUNNING_STATS_BLOCK elementos tem soma, mínimo, máximo e
+ * contagens calculados em aritmética inteira exata, e o M2 do bloco em
+ * relação à sua própria média é calculado em seguida com o bloco ainda no
+ * cache L1. O bloco é então combinado pela fórmula de Chan.
+ */
+static inline void running_stats_add_ints(RunningStats *s, const int *values, long long count) {
+    for (long long start = 0; start < count; start += RUNNING_STATS_BLOCK) {
+        int len = (int)(count - start < RUNNING_STATS_BLOCK ? count - start : RUNNING_STATS_BLOCK);
+        const int *v = values + start;
+
+        long long sum = 0, neg = 0, zeros = 0;
+        int min = v[0], max = v[0];
+        for (int i = 0; i < len; i++) {
+            sum += v[i];
+            neg += v[i] < 0;
+            zeros += v[i] == 0;
+            min = v[i] < min ? v[i] : min;
+            max = v[i] > max ? v[i] : max;
+        }
+
+        RunningStats block;
+        block.count = len;
+        block.mean = (double)sum / len;
+        block.m2 = 0.0;
+        for (int i = 0; i < len; i++) {
+            double d = v[i] - block.mean;
+            block.m2 += d * d;
+        }
+        block.min = min;
+        block.max = max;
+        block.negatives = neg;
+        block.zeros = zeros;
+        running_stats_merge(s, &block);
+    }
+}
+
+// Acumula `count` zeros de uma vez, sem ler memória (blocos esparsos)
+static inline void running_stats_add_zeros(RunningStats *s, long long count) {
+    if (count <= 0) return;
+    RunningStats zeros = {count, 0.0, 0.0, 0.0, 0.0, 0, count};
+    running_stats_merge(s, &zeros);
+}
+
+// Acumula um único valor (Welford)
+static inline void running_stats_push(RunningStats *s, double x) {
+    s->count++;
+    double delta = x - s->mean;
+    s->mean += delta / s->count;
+    s->m2 += delta * (x - s->mean);
+    if (x < s->min) s->min = x;
+    if (x > s->max) s->max = x;
+    s->negatives += x < 0;
+    s->zeros += x == 0;
+}
+
+// Variância populacional (divide por n), como nos programas originais
+static inline double running_stats_variance(const RunningStats *s) {
+    return s->count > 0 ? s->m2 / s->count : 0.0;
+}
+
+#ifdef MPI_VERSION
+
+static void running_stats_mpi_merge(void *in, void *inout, int *len, MPI_Datatype *datatype) {
+    (void)datatype;
+    const RunningStats *a = (const RunningStats *)in;
+    RunningStats *b = (RunningStats *)inout;
+    for (int i = 0; i < *len; i++) running_stats_merge(&b[i], &a[i]);
+}
+
+/**
+ * Cria o tipo e a operação MPI para RunningStats. Uso:
+ *
+ *     MPI_Datatype type; MPI_Op op;
+ *     running_stats_mpi_init(&type, &op);
+ *     MPI_Reduce(&local, &global, 1, type, op, 0, MPI_COMM_WORLD);
+ *     running_stats_mpi_free(&type, &op);
+ *
+ * A operação é declarada comutativa: a fórmula de Chan é simétrica (a menos
+ * de arredondamento), o que deixa a implementação MPI escolher a árvore.
+ */
+static inline void running_stats_mpi_init(MPI_Datatype *type, MPI_Op *op) {
+    MPI_Type_contiguous(sizeof(RunningStats), MPI_BYTE, type);
+    MPI_Type_commit(type);
+    MPI_Op_create(running_stats_mpi_merge, 1, op);
+}
+
+static inline void running_stats_mpi_free(MPI_Datatype *type, MPI_Op *op) {
+    MPI_Op_free(op);
+    MPI_Type_free(type);
+}
+
+#endif // MPI_VERSION
+
+#endif // RUNNING_STATS_H
@@ -0,0 +1,155 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+/**
+ * Blocos de linhas de uma matriz de int32 em formato denso, bitmap+valores
+ * ou CSR, escolhido pela fração de zeros.
+ *
+ * O bloco codificado é um vetor contíguo de int32, pronto para ir pela rede
+ * (MPI_Scatterv com MPI_INT) ou para o disco:
+ *
+ *     [formato, linhas, colunas, nnz]  cabeçalho
+ *     denso:   linhas*colunas valores
+ *     bitmap:  ceil(linhas*colunas/32) palavras (bit 1 = não zero), nnz valores
+ *     CSR:     linhas+1 row_ptr, nnz col_idx, nnz valores
+ *
+ * Abaixo do limiar de zeros o bloco fica denso. Acima dele, fica o menor
+ * entre bitmap (1 bit por elemento + 4 bytes por não zero) e CSR (8 bytes
+ * por não zero + 4 por linha), ou seja, CSR só quando menos de ~3% dos
+ * elementos são não zeros.
+ *
+ * As estatísticas (sparse_block_stats) leem só os valores não zero, com o
+ * kernel que o chamador escolher; os zeros entram de uma vez, sem ler
+ * memória (running_stats_add_zeros).
+ *
+ * Header-only: basta incluir (compilar com -I<raiz>/common).
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "running_stats.h"
+
+#define SPARSE_DENSE  0
+#define SPARSE_BITMAP 1
+#define SPARSE_CSR    2
+
+#define SPARSE_HEADER_INTS 4
+
+static inline long long sparse_bitmap_words(long long elements) {
+    return (elements + 31) / 32;
+}
+
+// Capacidade (em int32) necessária para codificar um bloco de `elements`
+static inline long long sparse_encode_capacity(long long elements) {
+    return SPARSE_HEADER_INTS + sparse_bitmap_words(elements) + elements;
+}
+
+// Tamanho (em int32) de um bloco já codificado
+static inline long long sparse_encoded_ints(const int32_t *block) {
+    long long rows = block[1], cols = block[2], nnz = block[3];
+    switch (block[0]) {
+    case SPARSE_BITMAP: return SPARSE_HEADER_INTS + sparse_bitmap_words(rows * cols) + nnz;
+    case SPARSE_CSR:    return SPARSE_HEADER_INTS + rows + 1 + 2 * nnz;
+    default:            return SPARSE_HEADER_INTS + rows * cols;
+    }
+}
+
+/**
+ * Codifica `rows` linhas de `cols` colunas em `out` (com pelo menos
+ * sparse_encode_capacity(rows * cols) int32) e devolve o tamanho em int32.
+ * Os dados de entrada são lidos uma única vez: o bitmap e a compactação dos
+ * não zeros saem na mesma varredura; a decisão de formato vem depois, a
+ * partir do nnz, e só mexe nos dados já compactados (ou recopia o bloco
+ * denso, se não valer a pena).
+ */
+static inline long long sparse_encode(const int32_t *data, int rows, int cols,
+                                      double zero_threshold, int32_t *out) {
+    long long elements = (long long)rows * cols;
+    long long words = sparse_bitmap_words(elements);
+    uint32_t *bitmap = (uint32_t *)(out + SPARSE_HEADER_INTS);
+    int32_t *values = out + SPARSE_HEADER_INTS + words;
+
+    // Compactação sem desvios: todo valor é escrito, mas o índice só avança
+    // nos não zeros
+    long long nnz = 0;
+    for (long long w = 0; w < words; w++) {
+        long long base = w * 32;
+        int bits_in_word = elements - base < 32 ? (int)(elements - base) : 32;
+        uint32_t bits = 0;
+        for (int b = 0; b < bits_in_word; b++) {
+            int32_t x = data[base + b];
+            bits |= (uint32_t)(x != 0) << b;
+            values[nnz] = x;
+            nnz += x != 0;
+        }
+        bitmap[w] = bits;
+    }
+
+    out[1] = rows;
+    out[2] = cols;
+    out[3] = (int32_t)nnz;
+
+    double zero_fraction = elements > 0 ? 1.0 - (double)nnz / elements : 0.0;
+    uint32_t *bits = NULL;
+    if (zero_fraction <= zero_threshold) {
+        out[0] = SPARSE_DENSE;
+        memcpy(out + SPARSE_HEADER_INTS, data, elements * sizeof(int32_t));
+    } else if (rows + 1 + 2 * nnz < words + nnz &&
+               (bits = (uint32_t *)malloc(words * sizeof(uint32_t))) != NULL) {
+        // CSR é menor: row_ptr + col_idx + valores cabem antes do fim do
+        // bitmap, então os valores só andam para trás (memmove) e os
+        // índices são reconstruídos a partir de uma cópia do bitmap (sem
+        // memória para a cópia, fica o bitmap, que já está pronto)
+        memcpy(bits, bitmap, words * sizeof(uint32_t));
+        int32_t *row_ptr = out + SPARSE_HEADER_INTS;
+        int32_t *col_idx = row_ptr + rows + 1;
+        memmove(col_idx + nnz, values, nnz * sizeof(int32_t));
+
+        long long k = 0;
+        int r = 0;
+        row_ptr[0] = 0;
+        for (long long w = 0; w < words; w++) {
+            uint32_t word = bits[w];
+            while (word != 0) {
+                long long e = w * 32 + __builtin_ctz(word);
+                word &= word - 1;
+                int row = (int)(e / cols);
+                while (r < row) row_ptr[++r] = (int32_t)k;
+                col_idx[k++] = (int32_t)(e % cols);
+            }
+        }
+        while (r < rows) row_ptr[++r] = (int32_t)k;
+        free(bits);
+        out[0] = SPARSE_CSR;
+    } else {
+        out[0] = SPARSE_BITMAP;
+    }
+    return sparse_encoded_ints(out);
+}
+
+// Valores armazenados no bloco (todos, se denso; só os não zeros, senão)
+static inline const int32_t *sparse_block_values(const int32_t *block, long long *count) {
+    long long rows = block[1], cols = block[2], nnz = block[3];
+    const int32_t *payload = block + SPARSE_HEADER_INTS;
+    switch (block[0]) {
+    case SPARSE_BITMAP: *count = nnz; return payload + sparse_bitmap_words(rows * cols);
+    case SPARSE_CSR:    *count = nnz; return payload + rows + 1 + nnz;
+    default:            *count = rows * cols; return payload;
+    }
+}
+
+/**
+ * Acumula as estatísticas do bloco lendo só os valores armazenados.
+ * `add_ints` é o kernel usado nos valores: running_stats_add_ints ou, com
+ * stats_kernels.h, stats_reduce_i32.
+ */
+static inline void sparse_block_stats(const int32_t *block, RunningStats *s,
+                                      void (*add_ints)(RunningStats *, const int *, long long)) {
+    long long stored;
+    const int32_t *values = sparse_block_values(block, &stored);
+    add_ints(s, values, stored);
+    if (block[0] != SPARSE_DENSE) running_stats_add_zeros(s, (long long)block[1] * block[2] - block[3]);
+}
+
+#endif // SPARSE_MATRIX_H
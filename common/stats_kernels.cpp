@@ -0,0 +1,22 @@
+#include "stats_kernels.hpp"
+#include "stats_kernels.h"
+
+extern "C" {
+
+void stats_reduce_i32(RunningStats *stats, const int *v, long long n) {
+    stats::reduce<std::int32_t>(stats, v, static_cast<std::size_t>(n));
+}
+
+void stats_reduce_i64(RunningStats *stats, const long long *v, long long n) {
+    stats::reduce<std::int64_t>(stats, reinterpret_cast<const std::int64_t *>(v), static_cast<std::size_t>(n));
+}
+
+void stats_reduce_f32(RunningStats *stats, const float *v, long long n) {
+    stats::reduce<float>(stats, v, static_cast<std::size_t>(n));
+}
+
+void stats_reduce_f64(RunningStats *stats, const double *v, long long n) {
+    stats::reduce<double>(stats, v, static_cast<std::size_t>(n));
+}
+
+}
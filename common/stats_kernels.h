@@ -0,0 +1,28 @@
+#ifndef STATS_KERNELS_H
+#define STATS_KERNELS_H
+
+/**
+ * Interface C para os kernels de stats_kernels.hpp. Cada função acumula os
+ * `n` elementos em `stats` (que deve ter sido iniciado com
+ * running_stats_init) usando o kernel vetorizado do tipo correspondente.
+ *
+ * Compilar stats_kernels.cpp com g++ (-O3 -march=native -fopenmp-simd) e ligar o objeto
+ * junto com o programa C; o objeto não depende da libstdc++.
+ */
+
+#include "running_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void stats_reduce_i32(RunningStats *stats, const int *v, long long n);
+void stats_reduce_i64(RunningStats *stats, const long long *v, long long n);
+void stats_reduce_f32(RunningStats *stats, const float *v, long long n);
+void stats_reduce_f64(RunningStats *stats, const double *v, long long n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STATS_KERNELS_H
@@ -0,0 +1,266 @@
+#ifndef STATS_KERNELS_HPP
+#define STATS_KERNELS_HPP
+
+/**
+ * Kernels de redução vetorizados e sem desvios para vetores de int32, int64,
+ * float e double: negativos, zeros, mínimo, máximo, soma e soma dos
+ * quadrados num único passe pela memória.
+ *
+ * Os dados são processados em blocos de STATS_KERNEL_BLOCK elementos. Em
+ * cada bloco, uma primeira varredura SIMD calcula soma (em acumulador
+ * alargado), extremos e contagens; uma segunda varredura, com o bloco ainda
+ * no cache L1, calcula o M2 em relação à média do bloco. Os blocos são
+ * combinados pela fórmula de Chan (running_stats.h), então a memória é lida
+ * uma vez só e a "soma dos quadrados" nunca sofre cancelamento:
+ * sum_squares = M2 + sum^2 / n.
+ *
+ * Para int32 há caminhos explícitos em AVX-512 e AVX2 (escolhidos em tempo
+ * de compilação: compile com -march=native); os outros tipos e máquinas
+ * usam o laço genérico, escrito para o compilador vetorizar (-O3
+ * -fopenmp-simd, que ativa as reduções de "#pragma omp simd").
+ *
+ * Acumuladores: int32 -> soma em int64 (exata); int64 -> soma em __int128;
+ * float/double -> soma em double. Contagens sempre em 64 bits. Em float e
+ * double, NaN não é tratado.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+extern "C" {
+#include "running_stats.h"
+}
+
+namespace stats {
+
+constexpr std::size_t STATS_KERNEL_BLOCK = 2048; // 8 KiB de int32: cabe com folga no L1
+
+// Tipo do acumulador da soma para cada tipo de elemento
+template <class T> struct SumType { using type = double; };
+template <> struct SumType<std::int32_t> { using type = std::int64_t; };
+template <> struct SumType<std::int64_t> { using type = __int128; };
+
+// Resultado de um bloco, antes de virar RunningStats
+template <class T>
+struct BlockResult {
+    typename SumType<T>::type sum;
+    T min, max;
+    long long negatives, zeros;
+};
+
+// Primeira varredura genérica: sem desvios (comparações viram 0/1 e
+// min/max viram seleções), o que permite ao compilador vetorizar o laço.
+template <class T>
+inline BlockResult<T> scan_block(const T *v, std::size_t n) {
+    using S = typename SumType<T>::type;
+    S sum = 0;
+    long long neg = 0, zeros = 0;
+    T min = v[0], max = v[0];
+    #pragma omp simd reduction(+:sum, neg, zeros) reduction(min:min) reduction(max:max)
+    for (std::size_t i = 0; i < n; i++) {
+        T x = v[i];
+        sum += static_cast<S>(x);
+        neg += x < T(0);
+        zeros += x == T(0);
+        min = x < min ? x : min;
+        max = x > max ? x : max;
+    }
+    return {sum, min, max, neg, zeros};
+}
+
+// Segunda varredura genérica (bloco já no L1): soma dos desvios ao quadrado
+template <class T>
+inline double block_m2(const T *v, std::size_t n, double mean) {
+    double m2 = 0.0;
+    #pragma omp simd reduction(+:m2)
+    for (std::size_t i = 0; i < n; i++) {
+        double d = static_cast<double>(v[i]) - mean;
+        m2 += d * d;
+    }
+    return m2;
+}
+
+#if defined(__AVX512F__)
+
+// Falso positivo do gcc 12 nos intrínsecos AVX-512 (_mm512_undefined_*)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+inline std::int64_t hsum_epi64(__m512i v) { return _mm512_reduce_add_epi64(v); }
+
+template <>
+inline BlockResult<std::int32_t> scan_block<std::int32_t>(const std::int32_t *v, std::size_t n) {
+    __m512i vmin = _mm512_set1_epi32(std::numeric_limits<std::int32_t>::max());
+    __m512i vmax = _mm512_set1_epi32(std::numeric_limits<std::int32_t>::min());
+    __m512i sum_lo = _mm512_setzero_si512(), sum_hi = _mm512_setzero_si512();
+    __m512i zero = _mm512_setzero_si512();
+    long long neg = 0, zeros = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_loadu_si512(reinterpret_cast<const void *>(v + i));
+        vmin = _mm512_min_epi32(vmin, x);
+        vmax = _mm512_max_epi32(vmax, x);
+        // Alarga para 64 bits antes de somar: nada de estouro
+        sum_lo = _mm512_add_epi64(sum_lo, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)));
+        sum_hi = _mm512_add_epi64(sum_hi, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1)));
+        neg += __builtin_popcount(_mm512_cmplt_epi32_mask(x, zero));
+        zeros += __builtin_popcount(_mm512_cmpeq_epi32_mask(x, zero));
+    }
+    BlockResult<std::int32_t> r;
+    r.sum = hsum_epi64(_mm512_add_epi64(sum_lo, sum_hi));
+    r.min = _mm512_reduce_min_epi32(vmin);
+    r.max = _mm512_reduce_max_epi32(vmax);
+    r.negatives = neg;
+    r.zeros = zeros;
+    for (; i < n; i++) {
+        std::int32_t x = v[i];
+        r.sum += x;
+        r.negatives += x < 0;
+        r.zeros += x == 0;
+        r.min = x < r.min ? x : r.min;
+        r.max = x > r.max ? x : r.max;
+    }
+    return r;
+}
+
+template <>
+inline double block_m2<std::int32_t>(const std::int32_t *v, std::size_t n, double mean) {
+    __m512d vmean = _mm512_set1_pd(mean);
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_loadu_si512(reinterpret_cast<const void *>(v + i));
+        __m512d d0 = _mm512_sub_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(x)), vmean);
+        __m512d d1 = _mm512_sub_pd(_mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(x, 1)), vmean);
+        acc0 = _mm512_fmadd_pd(d0, d0, acc0);
+        acc1 = _mm512_fmadd_pd(d1, d1, acc1);
+    }
+    double m2 = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+    for (; i < n; i++) {
+        double d = v[i] - mean;
+        m2 += d * d;
+    }
+    return m2;
+}
+
+#pragma GCC diagnostic pop
+
+#elif defined(__AVX2__)
+
+inline std::int64_t hsum_epi64(__m256i v) {
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+}
+
+inline std::int32_t hmin_epi32(__m256i v) {
+    __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(m);
+}
+
+inline std::int32_t hmax_epi32(__m256i v) {
+    __m128i m = _mm_max_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(m);
+}
+
+template <>
+inline BlockResult<std::int32_t> scan_block<std::int32_t>(const std::int32_t *v, std::size_t n) {
+    __m256i vmin = _mm256_set1_epi32(std::numeric_limits<std::int32_t>::max());
+    __m256i vmax = _mm256_set1_epi32(std::numeric_limits<std::int32_t>::min());
+    __m256i sum_lo = _mm256_setzero_si256(), sum_hi = _mm256_setzero_si256();
+    // Contadores por lane em 32 bits: o bloco tem bem menos que 2^31 elementos
+    __m256i neg = _mm256_setzero_si256(), zeros = _mm256_setzero_si256();
+    __m256i zero = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(v + i));
+        vmin = _mm256_min_epi32(vmin, x);
+        vmax = _mm256_max_epi32(vmax, x);
+        // Alarga para 64 bits antes de somar: nada de estouro
+        sum_lo = _mm256_add_epi64(sum_lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        sum_hi = _mm256_add_epi64(sum_hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+        // Comparações dão -1 por lane verdadeira; subtrair soma 1
+        neg = _mm256_sub_epi32(neg, _mm256_cmpgt_epi32(zero, x));
+        zeros = _mm256_sub_epi32(zeros, _mm256_cmpeq_epi32(x, zero));
+    }
+    BlockResult<std::int32_t> r;
+    r.sum = hsum_epi64(_mm256_add_epi64(sum_lo, sum_hi));
+    r.min = hmin_epi32(vmin);
+    r.max = hmax_epi32(vmax);
+    r.negatives = hsum_epi64(_mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(neg)),
+                                              _mm256_cvtepi32_epi64(_mm256_extracti128_si256(neg, 1))));
+    r.zeros = hsum_epi64(_mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(zeros)),
+                                          _mm256_cvtepi32_epi64(_mm256_extracti128_si256(zeros, 1))));
+    for (; i < n; i++) {
+        std::int32_t x = v[i];
+        r.sum += x;
+        r.negatives += x < 0;
+        r.zeros += x == 0;
+        r.min = x < r.min ? x : r.min;
+        r.max = x > r.max ? x : r.max;
+    }
+    return r;
+}
+
+template <>
+inline double block_m2<std::int32_t>(const std::int32_t *v, std::size_t n, double mean) {
+    __m256d vmean = _mm256_set1_pd(mean);
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(v + i));
+        __m256d d0 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(x)), vmean);
+        __m256d d1 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(x, 1)), vmean);
+        acc0 = _mm256_fmadd_pd(d0, d0, acc0);
+        acc1 = _mm256_fmadd_pd(d1, d1, acc1);
+    }
+    __m256d acc = _mm256_add_pd(acc0, acc1);
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double m2 = _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    for (; i < n; i++) {
+        double d = v[i] - mean;
+        m2 += d * d;
+    }
+    return m2;
+}
+
+#endif
+
+/**
+ * Acumula `n` elementos em `stats`. Pode ser chamado várias vezes (por
+ * exemplo, um bloco de linhas de cada vez) e o resultado é o mesmo de uma
+ * chamada só com todos os dados.
+ */
+template <class T>
+inline void reduce(RunningStats *stats, const T *v, std::size_t n) {
+    for (std::size_t start = 0; start < n; start += STATS_KERNEL_BLOCK) {
+        std::size_t len = n - start < STATS_KERNEL_BLOCK ? n - start : STATS_KERNEL_BLOCK;
+        BlockResult<T> b = scan_block(v + start, len);
+
+        RunningStats block;
+        block.count = static_cast<long long>(len);
+        block.mean = static_cast<double>(b.sum) / static_cast<double>(len);
+        block.m2 = block_m2(v + start, len, block.mean);
+        block.min = static_cast<double>(b.min);
+        block.max = static_cast<double>(b.max);
+        block.negatives = b.negatives;
+        block.zeros = b.zeros;
+        running_stats_merge(stats, &block);
+    }
+}
+
+// Soma dos quadrados recuperada de média e M2 (sem cancelamento no acúmulo)
+inline double sum_squares(const RunningStats &s) {
+    return s.m2 + s.mean * s.mean * static_cast<double>(s.count);
+}
+
+} // namespace stats
+
+#endif // STATS_KERNELS_HPP
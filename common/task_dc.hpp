@@ -0,0 +1,108 @@
+#ifndef TASK_DC_HPP
+#define TASK_DC_HPP
+
+/**
+ * Divisão e conquista com tarefas OpenMP e corte para o caminho serial.
+ *
+ *     struct Fib {
+ *         using Input = int;
+ *         using Result = long long;
+ *         static constexpr long long base = 1;                // size <= base: caso base
+ *         long long size(int n) const { return n; }
+ *         Result serial(int n) const { ... }                  // resolve a subárvore inteira
+ *         std::pair<int, int> split(int n) const { return {n - 1, n - 2}; }
+ *         Result combine(Result a, Result b) const { return a + b; }
+ *     };
+ *     dc::Options o;
+ *     o.cutoff = 20;
+ *     long long r = dc::solve(Fib(), 40, o);
+ *
+ * O exemplo clássico (exercicios/fib.c, aula 2/ex01*.c) cria duas tarefas
+ * em todo nível até n < 2: em fib(30) são 2,7 milhões de tarefas de poucos
+ * nanossegundos de trabalho cada, e o custo de criar, enfileirar e esperar
+ * cada uma domina. Aqui só os subproblemas maiores que `cutoff` viram
+ * tarefas; abaixo disso a subárvore inteira roda em `serial`, sem nenhuma
+ * diretiva OpenMP. Com o corte certo sobram algumas centenas de tarefas,
+ * o suficiente para balancear as threads.
+ *
+ * Modos (Options::mode):
+ *
+ *     dc::CUTOFF  abaixo do corte (ou da profundidade máxima) chama
+ *                 serial direto; o filho que cai abaixo do corte ainda é
+ *                 uma tarefa adiável comum.
+ *     dc::FINAL   o mesmo teste, e o filho que cai abaixo do corte vira uma
+ *                 tarefa final(true) `mergeable`: o runtime a executa na
+ *                 hora, por quem a criou, em vez de enfileirá-la. final()
+ *                 só decide o filho criado; a recursão de cada um (inclusive
+ *                 o que roda na própria tarefa, que nunca é final) para no
+ *                 corte pelo teste no código. Serve para comparar os dois
+ *                 jeitos de tratar as últimas tarefas.
+ *
+ * Em ambos o segundo filho roda na própria tarefa, em vez de virar outra
+ * tarefa que o pai só esperaria: metade das tarefas, mesmo paralelismo.
+ * cutoff = 0 (e max_depth = -1) reproduz o comportamento original, com
+ * tarefas até o caso base.
+ *
+ * Header-only: basta incluir (compilar com -fopenmp -I<raiz>/common).
+ */
+
+#include <utility>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace dc {
+
+enum Mode { CUTOFF, FINAL };
+
+struct Options {
+    long long cutoff = 20; // subproblemas com size <= cutoff rodam serial
+    int max_depth = -1;    // profundidade máxima de tarefas (-1 = sem limite)
+    Mode mode = CUTOFF;
+    int threads = 0;       // 0 = padrão do OpenMP (OMP_NUM_THREADS)
+};
+
+// Recursão paralela; chamada de dentro de uma região paralela (solve faz o
+// parallel + single)
+template <class P>
+typename P::Result solve_task(const P &p, const typename P::Input &in, const Options &o, int depth) {
+    long long n = p.size(in);
+    bool deep = o.max_depth >= 0 && depth >= o.max_depth;
+    // Nos dois modos: o filho que roda na própria tarefa não é final, então
+    // só este teste o impede de seguir dividindo abaixo do corte
+    if (n <= P::base || n <= o.cutoff || deep) return p.serial(in);
+#ifdef _OPENMP
+    if (o.mode == FINAL && omp_in_final()) return p.serial(in);
+#endif
+
+    std::pair<typename P::Input, typename P::Input> parts = p.split(in);
+    typename P::Result left, right;
+    // Modo FINAL: se o filho criado já está abaixo do corte, a tarefa é final
+    // (executada na hora, por quem a criou) e ele vai direto para serial
+    bool child_final = o.mode == FINAL && (p.size(parts.first) <= o.cutoff ||
+                                           (o.max_depth >= 0 && depth + 1 >= o.max_depth));
+    (void)child_final;
+    #pragma omp task default(shared) final(child_final) mergeable
+    left = solve_task(p, parts.first, o, depth + 1);
+    right = solve_task(p, parts.second, o, depth + 1);
+    #pragma omp taskwait
+    return p.combine(left, right);
+}
+
+template <class P>
+typename P::Result solve(const P &p, const typename P::Input &in, const Options &o = Options()) {
+    typename P::Result r;
+#ifdef _OPENMP
+    int team = o.threads > 0 ? o.threads : omp_get_max_threads();
+#endif
+    #pragma omp parallel num_threads(team)
+    {
+        #pragma omp single
+        r = solve_task(p, in, o, 0);
+    }
+    return r;
+}
+
+} // namespace dc
+
+#endif // TASK_DC_HPP
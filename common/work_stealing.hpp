@@ -0,0 +1,332 @@
+#ifndef WORK_STEALING_HPP
+#define WORK_STEALING_HPP
+
+/**
+ * Escalonador de tarefas com roubo de trabalho (deque de Chase-Lev), para
+ * recursões de granularidade fina.
+ *
+ *     ws::Scheduler sched(4);                  // 4 workers (o chamador é o 0)
+ *     long long r = sched.run([&] { return fib(40); });
+ *
+ *     long long fib(int n) {
+ *         if (n < 2) return n;
+ *         long long a, b;
+ *         ws::TaskGroup g;
+ *         g.spawn([&] { a = fib(n - 1); });    // pode ser roubada
+ *         b = fib(n - 2);                      // continua aqui
+ *         g.sync();                            // ajuda a executar até o grupo terminar
+ *         return a + b;
+ *     }
+ *
+ * Cada worker tem um deque: empilha e desempilha as suas tarefas numa ponta
+ * (LIFO, sem operações atômicas caras no caso comum) e os outros roubam da
+ * outra ponta as mais antigas, que em uma recursão são as maiores. O
+ * algoritmo é o de Chase e Lev, com as ordens de memória de Lê et al.
+ * ("Correct and efficient work-stealing for weak memory models", 2013).
+ *
+ * Os quadros das tarefas (o functor de spawn e o ponteiro para o contador
+ * do grupo) vêm de uma arena por worker: alocação é incrementar um ponteiro
+ * e o destrutor do TaskGroup devolve tudo o que foi alocado desde a sua
+ * criação. Isso vale porque os grupos são aninhados (fork-join estrito):
+ * crie TaskGroups como variáveis locais e não os guarde além do escopo.
+ *
+ * Um sync nunca bloqueia: enquanto o grupo tem tarefas pendentes, o worker
+ * executa as suas próprias ou rouba de outros. Se o deque ou a arena
+ * encherem, spawn simplesmente executa a tarefa na hora. Fora de
+ * Scheduler::run, spawn também executa na hora (serial).
+ *
+ * Comparado com `#pragma omp task`: sem cláusulas de ambiente de dados, sem
+ * alocação no heap por tarefa e sem a fila genérica do runtime; em
+ * recursões com muitas tarefas pequenas a diferença aparece
+ * (exercicios/ws_bench.cpp). Header-only, C++17: basta incluir (compilar
+ * com -pthread -I<raiz>/common).
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ws {
+
+constexpr std::int64_t DEQUE_CAPACITY = 1 << 14; // tarefas pendentes por worker (potência de 2)
+constexpr std::size_t ARENA_BYTES = 8 << 20;     // quadros vivos por worker
+constexpr std::size_t FRAME_ALIGN = 64;          // cada quadro na sua linha de cache
+constexpr int SPINS_BEFORE_YIELD = 64;           // tentativas de roubo antes de ceder a CPU
+
+// Cabeçalho de uma tarefa; o functor vem logo depois (FrameOf)
+struct Frame {
+    void (*invoke)(Frame *); // executa e destrói o functor
+    std::atomic<long> *pending;
+};
+
+template <class F>
+struct FrameOf : Frame {
+    F fn;
+    explicit FrameOf(F &&f) : fn(std::move(f)) { invoke = &FrameOf::call; }
+    static void call(Frame *frame) {
+        FrameOf *self = static_cast<FrameOf *>(frame);
+        self->fn();
+        self->~FrameOf();
+    }
+};
+
+// Executa o quadro e avisa o grupo; depois do fetch_sub o quadro (que pode
+// estar na arena de outro worker) não é mais tocado
+inline void run_frame(Frame *frame) {
+    std::atomic<long> *pending = frame->pending;
+    frame->invoke(frame);
+    pending->fetch_sub(1, std::memory_order_release);
+}
+
+// Deque de Chase-Lev de capacidade fixa. push e pop só pelo dono; steal por
+// qualquer thread
+class Deque {
+public:
+    bool push(Frame *frame) {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= DEQUE_CAPACITY) return false;
+        buffer_[b & (DEQUE_CAPACITY - 1)].store(frame, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Frame *pop() {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+        Frame *frame = nullptr;
+        if (t <= b) {
+            frame = buffer_[b & (DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+            if (t == b) {
+                // Último elemento: disputa com os ladrões pelo top
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    frame = nullptr;
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return frame;
+    }
+
+    Frame *steal() {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Frame *frame = buffer_[t & (DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr; // outro ladrão (ou o dono) levou
+        return frame;
+    }
+
+private:
+    // top (ladrões) e bottom (dono) em linhas de cache separadas
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    alignas(64) std::atomic<Frame *> buffer_[DEQUE_CAPACITY];
+};
+
+// Pilha de quadros: alocar incrementa, liberar volta a uma marca
+class Arena {
+public:
+    Arena() : base_(static_cast<char *>(std::aligned_alloc(FRAME_ALIGN, ARENA_BYTES))), top_(base_) {
+        if (base_ == nullptr) throw std::bad_alloc();
+    }
+    ~Arena() { std::free(base_); }
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(std::size_t bytes) {
+        bytes = (bytes + FRAME_ALIGN - 1) / FRAME_ALIGN * FRAME_ALIGN;
+        if (static_cast<std::size_t>(base_ + ARENA_BYTES - top_) < bytes) return nullptr;
+        void *p = top_;
+        top_ += bytes;
+        return p;
+    }
+    char *mark() const { return top_; }
+    void release(char *mark) { top_ = mark; }
+
+private:
+    char *base_, *top_;
+};
+
+class Scheduler;
+
+struct Worker {
+    Deque deque;
+    Arena arena;
+    Scheduler *scheduler;
+    int index;
+    std::uint64_t rng; // escolha da vítima (xorshift)
+};
+
+namespace detail {
+// Worker da thread atual (nullptr fora de Scheduler::run)
+inline thread_local Worker *current = nullptr;
+}
+
+class Scheduler {
+public:
+    explicit Scheduler(int threads = 0) {
+        int n = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+        if (n <= 0) n = 1;
+        for (int i = 0; i < n; i++) {
+            Worker *w = new Worker;
+            w->scheduler = this;
+            w->index = i;
+            w->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+            workers_.push_back(w);
+        }
+        // O worker 0 é a thread que chama run
+        for (int i = 1; i < n; i++) threads_.emplace_back(&Scheduler::loop, this, workers_[i]);
+    }
+
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread &t : threads_) t.join();
+        for (Worker *w : workers_) delete w;
+    }
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    int threads() const { return static_cast<int>(workers_.size()); }
+
+    // Executa f() com os workers ativos e devolve o seu resultado. Não é
+    // reentrante: uma chamada de run por vez
+    template <class F>
+    auto run(F f) -> decltype(f()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_.store(true, std::memory_order_release);
+        }
+        wake_.notify_all();
+        struct Leave {
+            Scheduler *s;
+            ~Leave() {
+                s->active_.store(false, std::memory_order_release);
+                detail::current = nullptr;
+            }
+        } leave{this};
+        detail::current = workers_[0];
+        return f();
+    }
+
+    // Executa uma tarefa: do próprio deque ou roubada. false se não achou
+    bool execute_one(Worker *w) {
+        Frame *frame = w->deque.pop();
+        if (frame == nullptr) frame = steal(w);
+        if (frame == nullptr) return false;
+        run_frame(frame);
+        return true;
+    }
+
+private:
+    Frame *steal(Worker *w) {
+        int n = threads();
+        if (n == 1) return nullptr;
+        w->rng ^= w->rng << 13;
+        w->rng ^= w->rng >> 7;
+        w->rng ^= w->rng << 17;
+        int start = static_cast<int>(w->rng % static_cast<std::uint64_t>(n));
+        for (int k = 0; k < n; k++) {
+            int victim = (start + k) % n;
+            if (victim == w->index) continue;
+            Frame *frame = workers_[victim]->deque.steal();
+            if (frame != nullptr) return frame;
+        }
+        return nullptr;
+    }
+
+    void loop(Worker *w) {
+        detail::current = w;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || active_.load(std::memory_order_acquire); });
+                if (stop_) return;
+            }
+            int misses = 0;
+            while (active_.load(std::memory_order_acquire)) {
+                if (execute_one(w)) misses = 0;
+                else if (++misses >= SPINS_BEFORE_YIELD) {
+                    std::this_thread::yield();
+                    misses = 0;
+                }
+            }
+        }
+    }
+
+    std::vector<Worker *> workers_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> active_{false};
+    bool stop_ = false;
+};
+
+// Conjunto de tarefas criadas por uma thread e esperadas juntas
+class TaskGroup {
+public:
+    TaskGroup() : worker_(detail::current), mark_(worker_ != nullptr ? worker_->arena.mark() : nullptr) {}
+    ~TaskGroup() {
+        sync();
+        if (worker_ != nullptr) worker_->arena.release(mark_);
+    }
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    template <class F>
+    void spawn(F &&f) {
+        using Fn = typename std::decay<F>::type;
+        if (worker_ != nullptr) {
+            void *memory = worker_->arena.allocate(sizeof(FrameOf<Fn>));
+            if (memory != nullptr) {
+                FrameOf<Fn> *frame = new (memory) FrameOf<Fn>(Fn(std::forward<F>(f)));
+                frame->pending = &pending_;
+                pending_.fetch_add(1, std::memory_order_relaxed);
+                if (!worker_->deque.push(frame)) run_frame(frame); // deque cheio
+                return;
+            }
+        }
+        f(); // fora do escalonador ou arena cheia
+    }
+
+    // Espera as tarefas do grupo, executando trabalho enquanto isso
+    void sync() {
+        if (worker_ == nullptr) return;
+        int misses = 0;
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (worker_->scheduler->execute_one(worker_)) misses = 0;
+            else if (++misses >= SPINS_BEFORE_YIELD) {
+                std::this_thread::yield();
+                misses = 0;
+            }
+        }
+    }
+
+private:
+    Worker *worker_;
+    char *mark_;
+    std::atomic<long> pending_{0};
+};
+
+} // namespace ws
+
+#endif // WORK_STEALING_HPP
@@ -4,6 +4,7 @@
 #include <omp.h>
 #include <time.h>
 #include <string.h>
+#include "progress.h" // Barra de progresso com contadores por thread (pasta common/ na raiz)
 
 #define MAX_LOG_SIZE 1024
 #define MAX_COMMAND_SIZE 1024
@@ -44,9 +45,10 @@ void compress_video_segment(const char* input_filename, const char* output_filen
     char command[MAX_COMMAND_SIZE];
     char log_msg[MAX_LOG_SIZE];
     
-    // Monta o comando FFmpeg para compressão com diferentes qualidades e segmentos
+    // Monta os argumentos do FFmpeg para compressão com diferentes qualidades e segmentos
+    // (o "ffmpeg" e as opções de progresso vêm de progress_ffmpeg)
     snprintf(command, sizeof(command),
-             "ffmpeg -i %s -ss %d -t %d -vcodec libx264 -crf %d %s",
+             "-i %s -ss %d -t %d -vcodec libx264 -crf %d %s",
              input_filename, start_time, duration, quality, output_filename);
     
     // Verificar truncamento
@@ -56,9 +58,29 @@ void compress_video_segment(const char* input_filename, const char* output_filen
 
     log_message(log_filename, rank, -1, log_msg);
     
+    // Progresso do segmento: tempo de vídeo já codificado, em microssegundos. O último
+    // segmento pode ser mais curto que `duration`; a duração do arquivo limita o total.
+    // Sob o mpirun a saída não é um terminal: cada rank escreve uma linha a cada 2 s
+    long long total_us = (long long)duration * 1000000;
+    long long media_us = progress_media_duration_us(input_filename);
+    if (media_us > 0 && media_us - start_time * 1000000LL < total_us) total_us = media_us - start_time * 1000000LL;
+    if (total_us < 0) total_us = 0;
+    char label[64];
+    snprintf(label, sizeof(label), "Rank %d (%s)", rank, output_filename);
+    Progress progress;
+    int show_progress = progress_start(&progress, label, total_us, 1, 0) == 0;
+    if (show_progress) progress_set_unit(&progress, "s de vídeo", 1e-6);
+
     // Executa o comando
     time_t start_exec = time(NULL); // Tempo de início da execução
-    system(command);
+    if (show_progress) {
+        progress_ffmpeg(&progress, 0, command);
+        progress_finish(&progress);
+    } else {
+        char full_command[MAX_COMMAND_SIZE + 16];
+        snprintf(full_command, sizeof(full_command), "ffmpeg %s", command);
+        system(full_command);
+    }
     time_t end_exec = time(NULL);   // Tempo de término da execução
     
     // Log após compressão com tempo de execução
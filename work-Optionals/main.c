@@ -34,6 +34,16 @@ int main(int argc, char* argv[]) {
     // Define o número máximo de threads para a execução paralela usando OpenMP.
     omp_set_num_threads(MAX_THREADS);
 
+    // Barra de progresso: um slot por thread, total = duração do vídeo vezes o número de resoluções (em microssegundos).
+    // Uma única thread de relatório desenha a barra; as threads de trabalho só atualizam o próprio contador.
+    Progress progress;
+    long long duration_us = progress_media_duration_us(input_file);
+    if (progress_start(&progress, "Transcodificação", duration_us * (long long)num_resolutions, MAX_THREADS, 1) != 0) {
+        fprintf(stderr, "Error starting the progress reporter\n");
+        return 1;
+    }
+    progress_set_unit(&progress, "s de vídeo", 1e-6);
+
     // Inicia uma região paralela, onde múltiplas threads podem executar o código simultaneamente.
     #pragma omp parallel
     {
@@ -42,9 +52,6 @@ int main(int argc, char* argv[]) {
         // Cada thread executa um loop sobre as resoluções atribuídas a ela.
         #pragma omp for
         for (size_t i = 0; i < num_resolutions; ++i) {
-            // Imprime uma mensagem indicando qual thread está processando qual resolução.
-            printf("Thread %d processando resolução %zu\n", thread_id, i);
-
             // Cria o prefixo do nome do arquivo de saída baseado no índice da resolução.
             char output_file_prefix[64];
             snprintf(output_file_prefix, sizeof(output_file_prefix), "output_%zu", i + 1);
@@ -60,9 +67,12 @@ int main(int argc, char* argv[]) {
             }
 
             // Chama a função `transcode_video` para transcodificar o vídeo para a resolução atual.
-            transcode_video(input_file, &resolutions[i], 1, output_file_prefix, thread_id);
+            transcode_video(input_file, &resolutions[i], 1, output_file_prefix, thread_id, &progress);
         }
     }
 
+    // Para a thread de relatório e desenha a barra final.
+    progress_finish(&progress);
+
     return 0;  // Retorna 0 para indicar que o programa foi executado com sucesso.
 }
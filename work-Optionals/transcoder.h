@@ -2,6 +2,7 @@
 #define TRANSCODER_H
 
 #include <stdlib.h>  // Inclui a biblioteca padrão para utilitários gerais, como `size_t`.
+#include "progress.h" // Barra de progresso com contadores por thread (pasta common/ na raiz).
 
 /**
  * @brief Transcodifica um vídeo para diferentes resoluções.
@@ -19,8 +20,12 @@
  *                           arquivo de saída. A resolução será concatenada
  *                           com esse prefixo para formar o nome completo do
  *                           arquivo de saída.
+ * @param thread_id Identificador da thread, usado no log e como slot de
+ *                  `progress`.
+ * @param progress Barra de progresso: o slot `thread_id` avança com o tempo
+ *                 de vídeo já codificado, em microssegundos.
  */
-void transcode_video(const char* input_file, const char* resolutions[], size_t num_resolutions, const char* output_file_prefix, int thread_id);
+void transcode_video(const char* input_file, const char* resolutions[], size_t num_resolutions, const char* output_file_prefix, int thread_id, Progress* progress);
 
 #endif // TRANSCODER_H
 